@@ -0,0 +1,417 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-23 Bradley M. Bell
+// ----------------------------------------------------------------------------
+
+# include <algorithm>
+# include <cstdlib>
+# include <limits>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/wait.h>
+# include <dismod_at/cross_validate_command.hpp>
+# include <dismod_at/error_exit.hpp>
+# include <dismod_at/get_table_column.hpp>
+# include <dismod_at/does_table_exist.hpp>
+# include <dismod_at/fit_model.hpp>
+# include <dismod_at/exec_sql_cmd.hpp>
+# include <dismod_at/create_table.hpp>
+# include <dismod_at/get_var_limits.hpp>
+# include <dismod_at/remove_const.hpp>
+# include <dismod_at/get_str_map.hpp>
+# include <dismod_at/get_rate_table.hpp>
+# include <dismod_at/open_connection.hpp>
+# include <dismod_at/thread_pool.hpp>
+
+namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
+/*
+-----------------------------------------------------------------------------
+{xrst_begin cross_validate_command}
+
+The Cross Validate Command
+##########################
+
+Syntax
+******
+
+   ``dismod_at`` *database* ``cross_validate`` *n_fold*
+
+Purpose
+*******
+This command does *n_fold* fold cross validation using one execution
+of ``dismod_at`` .
+The input tables are read, and the data and prior models are constructed,
+once for all the folds.
+Doing the same thing with a separate
+:ref:`hold_out<hold_out_command-name>` and :ref:`fit<fit_command-name>`
+command for each fold repeats all of this work.
+
+database
+********
+Is an
+http://www.sqlite.org/sqlite/ database containing the
+``dismod_at`` :ref:`input-name` tables which are not modified.
+
+n_fold
+******
+This is the number of folds and must be greater than one.
+It cannot be greater than the number of data points that are
+included in the fit; i.e., that are not held out by the
+:ref:`fit_command@hold_out` rules for the fit command.
+
+Folds
+*****
+Let *fit_list* be the list of
+:ref:`data_subset_table@data_subset_id` values that are
+included in a fit, in increasing order.
+The *k*-th element of *fit_list* is in fold
+*k* % *n_fold* .
+For each fold, both the fixed and random effects are fit
+(as in the fit command with :ref:`fit_command@variables` equal to
+``both`` ) with the data in that fold held out.
+The data points that are held out by the hold_out rules
+are not in any fold and are held out of every fit.
+
+Starting Point
+**************
+If the :ref:`fit_var_table-name` exists,
+the fit for each fold starts at the
+:ref:`fit_var_table@fit_var_value` ; e.g., the result of fitting
+all the data with the fit command.
+Otherwise, the fit for each fold starts at the
+:ref:`start_var_table-name` values.
+
+n_thread
+********
+The fits for different folds are independent.
+If the :ref:`option_table@n_thread` option is greater than one,
+they are divided among *n_thread* separate processes
+(instead of threads because the optimizers are not thread safe).
+Each process uses its own connection to *database* for
+:ref:`log_table-name` messages.
+The results do not depend on *n_thread* .
+
+cross_validate_table
+********************
+A new ``cross_validate`` table is created each time this command is run.
+There is one row in this table for each element of *fit_list* ,
+in the same order as *fit_list* , with the following columns:
+
+.. csv-table::
+   :widths: auto
+
+   Name,Type,Description
+   cross_validate_id,integer,primary key for this table
+   data_subset_id,integer,data subset table row for this data point
+   fold,integer,the fold that held out this data point
+   avg_integrand,real,average integrand using the fit for this fold
+   weighted_residual,real,weighted residual using the fit for this fold
+
+The :ref:`fit_data_subset_table@avg_integrand` and
+:ref:`fit_data_subset_table@weighted_residual` are defined
+as in the fit_data_subset table.
+They are computed using the fit for the fold that held this data out;
+i.e., they check how well a fit predicts data that it did not see.
+{xrst_toc_hidden
+   example/get_started/cross_validate_command.py
+}
+Example
+*******
+The file :ref:`cross_validate_command.py-name` contains an example and test
+using this command.
+
+{xrst_end cross_validate_command}
+*/
+
+// ----------------------------------------------------------------------------
+void cross_validate_command(
+   const std::string&                                   n_fold_arg        ,
+   sqlite3*                                             db                ,
+   const CppAD::vector<dismod_at::subset_data_struct>&  subset_data_obj   ,
+   dismod_at::data_model&                               data_object       ,
+   const dismod_at::prior_model&                        prior_object      ,
+   const dismod_at::pack_info&                          pack_object       ,
+   const dismod_at::pack_prior&                         var2prior         ,
+   const dismod_at::db_input_struct&                    db_input          ,
+   // effectively const
+   const std::map<std::string, std::string>&            option_map
+)
+{  using std::string;
+   using CppAD::vector;
+   string msg;
+   // -----------------------------------------------------------------------
+   // fit_list
+   size_t n_subset = subset_data_obj.size();
+   vector<size_t> fit_list;
+   for(size_t subset_id = 0; subset_id < n_subset; ++subset_id)
+   {  if( subset_data_obj[subset_id].hold_out == 0 )
+         fit_list.push_back(subset_id);
+   }
+   size_t n_fit = fit_list.size();
+   //
+   // n_fold
+   int n_fold_int = std::atoi( n_fold_arg.c_str() );
+   if( n_fold_int < 2 || size_t(n_fold_int) > n_fit )
+   {  msg  = "dismod_at cross_validate command: n_fold = " + n_fold_arg;
+      msg += "\nis less than 2 or greater than the number of data points";
+      msg += "\nthat are included in the fit = " + CppAD::to_string(n_fit);
+      dismod_at::error_exit(msg);
+   }
+   size_t n_fold = size_t( n_fold_int );
+   // -----------------------------------------------------------------------
+   // start_var
+   vector<double> start_var;
+   string table_name  = "start_var";
+   string column_name = "start_var_value";
+   if( dismod_at::does_table_exist(db, "fit_var") )
+   {  table_name  = "fit_var";
+      column_name = "fit_var_value";
+   }
+   dismod_at::get_table_column(db, table_name, column_name, start_var);
+   //
+   // scale_var
+   vector<double> scale_var;
+   table_name  = "scale_var";
+   column_name = "scale_var_value";
+   dismod_at::get_table_column(db, table_name, column_name, scale_var);
+   // ----------------------------------------------------------------------
+   // zero_sum_child_rate
+   size_t n_rate      = size_t(dismod_at::number_rate_enum);
+   size_t option_size = get_str_map(option_map, "zero_sum_child_rate").size();
+   vector<bool> zero_sum_child_rate(n_rate);
+   for(size_t rate_id = 0; rate_id < n_rate; rate_id++)
+   {  string rate_name = dismod_at::get_rate_name(rate_id);
+      size_t found     =
+         get_str_map(option_map, "zero_sum_child_rate").find( rate_name );
+      zero_sum_child_rate[rate_id] = found < option_size;
+   }
+   // ----------------------------------------------------------------------
+   // zero_sum_mulcov_group
+   size_t n_group = pack_object.group_size();
+   option_size    = get_str_map(option_map, "zero_sum_mulcov_group").size();
+   vector<bool> zero_sum_mulcov_group(n_group);
+   for(size_t group_id = 0; group_id < n_group; group_id++)
+   {  const vector<subgroup_struct>&
+         subgroup_table( db_input.subgroup_table );
+      size_t first_subgroup_id = pack_object.first_subgroup_id(group_id);
+      string group_name = subgroup_table[first_subgroup_id].group_name;
+      size_t found =
+         get_str_map(option_map, "zero_sum_mulcov_group").find(group_name);
+      zero_sum_mulcov_group[group_id] = found < option_size;
+   }
+   // ----------------------------------------------------------------------
+   // random_const
+   size_t n_var    = pack_object.size();
+   size_t n_random = pack_object.random_size();
+   CppAD::mixed::d_vector var_lower(n_var), var_upper(n_var);
+   get_var_limits(
+      var_lower, var_upper, var2prior, db_input.prior_table
+   );
+   CppAD::mixed::d_vector random_lower(n_random);
+   CppAD::mixed::d_vector random_upper(n_random);
+   unpack_random(pack_object, var_lower, random_lower);
+   unpack_random(pack_object, var_upper, random_upper);
+   remove_const random_const(random_lower, random_upper);
+   // ----------------------------------------------------------------------
+   // bound_random
+   // null corresponds to infinity
+   double bound_random = std::numeric_limits<double>::infinity();
+   string tmp_str      = get_str_map(option_map, "bound_random");
+   if( tmp_str != "" )
+      bound_random = std::atof( tmp_str.c_str() );
+   //
+   // quasi_fixed
+   bool quasi_fixed = get_str_map(option_map, "quasi_fixed") == "true";
+   //
+   // trace_init
+   bool trace_init =
+      get_str_map(option_map, "trace_init_fit_model") == "true";
+   //
+   // warn_on_stderr
+   bool warn_on_stderr = get_str_map(option_map, "warn_on_stderr") == "true";
+   // ----------------------------------------------------------------------
+   // fit_fold
+   // Fits with the data in one fold held out. For k = fold, fold + n_fold,
+   // ..., sets avg_out[k] and wres_out[k] to the average integrand and
+   // weighted residual for fit_list[k]. The connection db_fit is used to
+   // log messages.
+   auto fit_fold = [&](
+      size_t fold, sqlite3* db_fit, double* avg_out, double* wres_out
+   )
+   {  // hold out the data in this fold
+      vector<dismod_at::subset_data_struct> fold_data_obj( subset_data_obj );
+      for(size_t k = fold; k < n_fit; k += n_fold)
+         fold_data_obj[ fit_list[k] ].hold_out = 1;
+      data_object.replace_like(fold_data_obj);
+      //
+      // fit both fixed and random effects
+      int  simulate_index = -1;
+      bool random_only    = false;
+      CppAD::mixed::warm_start_struct warm_start_in;
+      dismod_at::fit_model fit_object(
+         db_fit               ,
+         simulate_index       ,
+         warn_on_stderr       ,
+         bound_random         ,
+         pack_object          ,
+         var2prior            ,
+         start_var            ,
+         scale_var            ,
+         db_input.prior_table ,
+         prior_object         ,
+         random_const         ,
+         quasi_fixed          ,
+         zero_sum_child_rate  ,
+         zero_sum_mulcov_group,
+         data_object          ,
+         trace_init
+      );
+      fit_object.run_fit(random_only, option_map, warm_start_in);
+      vector<double> opt_value, lag_value, lag_dage, lag_dtime;
+      vector<CppAD::mixed::trace_struct> trace_vec;
+      CppAD::mixed::warm_start_struct warm_start_out;
+      fit_object.get_solution(
+         opt_value, lag_value, lag_dage, lag_dtime, trace_vec, warm_start_out
+      );
+      //
+      // residuals for the data in this fold
+      for(size_t k = fold; k < n_fit; k += n_fold)
+      {  size_t subset_id = fit_list[k];
+         double avg = data_object.average(subset_id, opt_value);
+         double not_used;
+         dismod_at::residual_struct<double> residual =
+            data_object.like_one(subset_id, opt_value, avg, not_used);
+         avg_out[k]  = avg;
+         wres_out[k] = residual.wres;
+      }
+      //
+      // restore the hold out values
+      data_object.replace_like(subset_data_obj);
+   };
+   // ----------------------------------------------------------------------
+   // avg_vec, wres_vec
+   vector<double> avg_vec(n_fit), wres_vec(n_fit);
+   //
+   // n_process
+   // The fits use cppad_mixed and Ipopt which are not thread safe,
+   // so the folds are divided among separate processes.
+   size_t n_thread  = dismod_at::thread_pool_size();
+   size_t n_process = std::min(n_thread, n_fold);
+   if( n_process == 1 )
+   {  for(size_t fold = 0; fold < n_fold; ++fold)
+         fit_fold(fold, db, avg_vec.data(), wres_vec.data());
+   }
+   else
+   {  // file name for the database
+      string file_name = sqlite3_db_filename(db, "main");
+      //
+      // The thread pool is not copied by fork, so it is freed here
+      // and re-created after the processes are done.
+      dismod_at::free_thread_pool();
+      //
+      // shared memory where the processes store their results
+      size_t n_byte = 2 * n_fit * sizeof(double) + n_fold * sizeof(int);
+      void*  shared = mmap(
+         nullptr, n_byte,
+         PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0
+      );
+      if( shared == MAP_FAILED )
+      {  msg = "cross_validate_command: mmap failed for shared results";
+         dismod_at::error_exit(msg);
+      }
+      double* shared_avg  = reinterpret_cast<double*>(shared);
+      double* shared_wres = shared_avg + n_fit;
+      int*    shared_done = reinterpret_cast<int*>(shared_wres + n_fit);
+      for(size_t fold = 0; fold < n_fold; ++fold)
+         shared_done[fold] = 0;
+      //
+      // fork the processes
+      vector<pid_t> pid(n_process);
+      for(size_t p = 0; p < n_process; ++p)
+      {  pid[p] = fork();
+         if( pid[p] == 0 )
+         {  // This is a child process. It must not use the database
+            // connection of its parent, so it opens its own connection.
+            bool     new_file = false;
+            sqlite3* db_fit   =
+               dismod_at::open_connection(file_name, new_file);
+            sqlite3_busy_timeout(db_fit, 60000);
+            dismod_at::error_exit(db_fit);
+            for(size_t fold = p; fold < n_fold; fold += n_process)
+            {  fit_fold(fold, db_fit, shared_avg, shared_wres);
+               shared_done[fold] = 1;
+            }
+            sqlite3_close(db_fit);
+            _exit(0);
+         }
+         if( pid[p] < 0 )
+         {  msg = "cross_validate_command: fork failed";
+            dismod_at::error_exit(msg);
+         }
+      }
+      //
+      // wait for the processes to finish
+      bool ok = true;
+      for(size_t p = 0; p < n_process; ++p)
+      {  int status;
+         waitpid(pid[p], &status, 0);
+         ok &= WIFEXITED(status) && WEXITSTATUS(status) == 0;
+      }
+      for(size_t fold = 0; fold < n_fold; ++fold)
+         ok &= shared_done[fold] == 1;
+      //
+      // copy the results
+      for(size_t k = 0; k < n_fit; ++k)
+      {  avg_vec[k]  = shared_avg[k];
+         wres_vec[k] = shared_wres[k];
+      }
+      munmap(shared, n_byte);
+      dismod_at::new_thread_pool(n_thread);
+      if( ! ok )
+      {  msg  = "cross_validate_command: the fit for one of the folds ";
+         msg += "failed;\nsee the previous messages in the log table";
+         dismod_at::error_exit(msg);
+      }
+   }
+   // ----------------------------------------------------------------------
+   // cross_validate table
+   string sql_cmd = "drop table if exists cross_validate";
+   dismod_at::exec_sql_cmd(db, sql_cmd);
+   //
+   table_name   = "cross_validate";
+   size_t n_col = 4;
+   vector<string> col_name(n_col), col_type(n_col);
+   vector<bool>   col_unique(n_col);
+   //
+   col_name[0]   = "data_subset_id";
+   col_type[0]   = "integer";
+   col_unique[0] = false;
+   //
+   col_name[1]   = "fold";
+   col_type[1]   = "integer";
+   col_unique[1] = false;
+   //
+   col_name[2]   = "avg_integrand";
+   col_type[2]   = "real";
+   col_unique[2] = false;
+   //
+   col_name[3]   = "weighted_residual";
+   col_type[3]   = "real";
+   col_unique[3] = false;
+   //
+   vector<int>    int_value(2 * n_fit);
+   vector<double> real_value(2 * n_fit);
+   for(size_t k = 0; k < n_fit; ++k)
+   {  int_value[0 * n_fit + k]  = int( fit_list[k] );
+      int_value[1 * n_fit + k]  = int( k % n_fold );
+      real_value[0 * n_fit + k] = avg_vec[k];
+      real_value[1 * n_fit + k] = wres_vec[k];
+   }
+   dismod_at::create_table(
+      db, table_name, col_name, col_type, col_unique,
+      n_fit, int_value, real_value
+   );
+   return;
+}
+
+} // END_DISMOD_AT_NAMESPACE
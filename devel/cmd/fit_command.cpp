@@ -4,6 +4,7 @@
 // SPDX-FileContributor: 2014-22 Bradley M. Bell
 // ----------------------------------------------------------------------------
 
+# include <stdexcept>
 # include <dismod_at/fit_command.hpp>
 # include <dismod_at/error_exit.hpp>
 # include <dismod_at/get_prior_sim_table.hpp>
@@ -14,8 +15,11 @@
 # include <dismod_at/get_var_limits.hpp>
 # include <dismod_at/remove_const.hpp>
 # include <dismod_at/blob_table.hpp>
+# include <dismod_at/pack_fit_hes.hpp>
+# include <dismod_at/fit_input_hash.hpp>
 # include <dismod_at/pack_warm_start.hpp>
 # include <dismod_at/get_str_map.hpp>
+# include <dismod_at/thread_pool.hpp>
 
 namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
 /*
@@ -184,6 +188,21 @@ If *simulate_index* is present (is not present) the Hessian corresponds
 to the simulated measurements in the :ref:`data_sim_table-name`
 (measurements in the :ref:`data_table-name` ).
 
+fit_hes
+=======
+If *variables* is ``both`` and the
+:ref:`option_table@save_fit_hes` option is ``true`` ,
+a new ``fit_hes`` table is created.
+It contains the Hessians of the fixed and random effects objectives
+at the optimal variable values.
+The :ref:`sample asymptotic<sample_command@asymptotic>` command
+uses these Hessians, instead of recomputing them,
+when the :ref:`fit_var_table-name` and the
+:ref:`fit_input_hash@Tables` have not changed.
+Otherwise, a previous version of this table is removed.
+The contents of this table are unspecified; i.e., not part of the
+dismod_at API and may change.
+
 mixed_info
 ==========
 A new :ref:`mixed_info_table-name` table is created each time this command is run.
@@ -443,11 +462,11 @@ void fit_command(
       opt_value, lag_value, lag_dage, lag_dtime, trace_vec, warm_start_out
    );
    // ------------------ hes_random table ----------------------------------
+   // random_hes_rcv
+   CppAD::mixed::d_sparse_rcv random_hes_rcv;
    if( variables != "fixed" )
    {  //
-      // random_hes_rcv
-      CppAD::mixed::d_sparse_rcv random_hes_rcv =
-         fit_object.random_obj_hes(opt_value);
+      random_hes_rcv = fit_object.random_obj_hes(opt_value);
       //
       // drop previous verison of this table
       string sql_cmd = "drop table if exists hes_random";
@@ -487,6 +506,37 @@ void fit_command(
          db, table_name, col_name, col_type, col_unique, row_value
       );
    }
+   // ------------------ fit_hes table -------------------------------------
+   {  // drop previous verison of this table
+      string sql_cmd = "drop table if exists fit_hes";
+      dismod_at::exec_sql_cmd(db, sql_cmd);
+   }
+   bool save_fit_hes = get_str_map(option_map, "save_fit_hes") == "true";
+   if( variables == "both" && save_fit_hes )
+   {  //
+      // fixed_hes_rcv
+      CppAD::mixed::d_sparse_rcv fixed_hes_rcv =
+         fit_object.fixed_obj_hes(opt_value);
+      //
+      // input_hash
+      double input_hash = dismod_at::fit_input_hash(db, option_map);
+      //
+      // pack the Hessians, and the point they correspond to, in a vector
+      vector<double> vec = pack_fit_hes(
+         simulation_index,
+         bound_random,
+         input_hash,
+         opt_value,
+         fixed_hes_rcv,
+         random_hes_rcv
+      );
+      //
+      table_name         = "fit_hes";
+      string col_name    = "fit_hes";
+      size_t sizeof_data = vec.size() * sizeof(double);
+      void* data         = reinterpret_cast<void*>( vec.data() );
+      write_blob_table(db, table_name, col_name, sizeof_data, data);
+   }
    // ------------------ mixed_info table ----------------------------
    {  //
       // drop previous verison of this table
@@ -549,9 +599,13 @@ void fit_command(
    table_name   = "fit_var";
    assert( n_var == opt_value.size() );
    size_t n_col = 7;
-   vector<string> col_name(n_col), col_type(n_col), row_value(n_col * n_var);
+   vector<string> col_name(n_col), col_type(n_col), row_value;
    vector<bool>   col_unique(n_col);
    //
+   // all the columns in the fit_var table are real
+   vector<int>    int_value(0);
+   vector<double> real_value(n_col * n_var);
+   //
    col_name[0]       = "fit_var_value";
    col_type[0]       = "real";
    col_unique[0]     = false;
@@ -581,23 +635,24 @@ void fit_command(
    col_type[6]       = "real";
    col_unique[6]     = false;
    //
+   double nan = std::numeric_limits<double>::quiet_NaN();
    for(size_t var_id = 0; var_id < n_var; var_id++)
    {
       // fit_var_value
-      row_value[var_id * n_col + 0] = to_string( opt_value[var_id] );
+      real_value[0 * n_var + var_id] = opt_value[var_id];
       //
-      // initialzie residuals as empty (null in database)
+      // initialzie residuals as nan (null in database)
       for(size_t k = 1; k < 4; k++)
-         row_value[var_id * n_col + k] = "";
+         real_value[k * n_var + var_id] = nan;
       //
       // lagrange_value
-      row_value[var_id * n_col + 4] = to_string( lag_value[var_id] );
+      real_value[4 * n_var + var_id] = lag_value[var_id];
       //
       // lagrange_dage
-      row_value[var_id * n_col + 5] = to_string( lag_dage[var_id] );
+      real_value[5 * n_var + var_id] = lag_dage[var_id];
       //
       // lagrange_dtime
-      row_value[var_id * n_col + 6] = to_string( lag_dtime[var_id] );
+      real_value[6 * n_var + var_id] = lag_dtime[var_id];
    }
    // residual_value, residual_dage, residual_dtime
    for(size_t variable_type = 0; variable_type < 2; variable_type++)
@@ -612,11 +667,12 @@ void fit_command(
          size_t var_id = index / 3;
          size_t k      = 1 + index % 3;
          assert( var_id < n_var );
-         row_value[var_id * n_col + k] = to_string( residual[i].wres );
+         real_value[k * n_var + var_id] = residual[i].wres;
       }
    }
    dismod_at::create_table(
-      db, table_name, col_name, col_type, col_unique, row_value
+      db, table_name, col_name, col_type, col_unique,
+      n_var, int_value, real_value
    );
    // ------------------ fit_data_subset table --------------------------------
    sql_cmd = "drop table if exists fit_data_subset";
@@ -629,8 +685,6 @@ void fit_command(
    col_name.resize(n_col);
    col_type.resize(n_col);
    col_unique.resize(n_col);
-   row_value.clear();
-   row_value.resize(n_col * n_subset);
    //
    col_name[0]   = "avg_integrand";
    col_type[0]   = "real";
@@ -640,7 +694,9 @@ void fit_command(
    col_type[1]   = "real";
    col_unique[1] = false;
    //
-   for(size_t subset_id = 0; subset_id < n_subset; subset_id++)
+   // avg_vec, wres_vec
+   vector<double> avg_vec(n_subset), wres_vec(n_subset);
+   auto subset_job = [&](size_t subset_id)
    {  // compute average integrand for this data item
       double avg = data_object.average(subset_id, opt_value);
       assert( ! CppAD::isnan(avg) );
@@ -650,11 +706,28 @@ void fit_command(
       dismod_at::residual_struct<double> residual =
          data_object.like_one(subset_id, opt_value, avg, not_used);
       //
-      row_value[ subset_id * n_col + 0] = to_string( avg );
-      row_value[ subset_id * n_col + 1] = to_string( residual.wres );
+      avg_vec[subset_id]  = avg;
+      wres_vec[subset_id] = residual.wres;
+   };
+   // cohort solutions are cached for opt_value
+   data_object.set_cohort_cache(true);
+   //
+   // errors detected in parallel mode are reported here
+   try
+   {  dismod_at::thread_pool_run(n_subset, subset_job);
+   }
+   catch(const std::runtime_error& e)
+   {  dismod_at::error_exit( e.what() );
+   }
+   data_object.set_cohort_cache(false);
+   real_value.resize(n_col * n_subset);
+   for(size_t subset_id = 0; subset_id < n_subset; subset_id++)
+   {  real_value[0 * n_subset + subset_id] = avg_vec[subset_id];
+      real_value[1 * n_subset + subset_id] = wres_vec[subset_id];
    }
    dismod_at::create_table(
-      db, table_name, col_name, col_type, col_unique, row_value
+      db, table_name, col_name, col_type, col_unique,
+      n_subset, int_value, real_value
    );
    if( ! random_only )
    {  // -------------------- trace_fixed table -----------------------------
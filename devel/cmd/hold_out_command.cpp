@@ -5,7 +5,6 @@
 
 # include <gsl/gsl_randist.h>
 # include <cppad/utility/to_string.hpp>
-# include <cppad/mixed/manage_gsl_rng.hpp>
 # include <dismod_at/exec_sql_cmd.hpp>
 # include <dismod_at/create_table.hpp>
 # include <dismod_at/get_integrand_table.hpp>
@@ -13,6 +12,7 @@
 # include <dismod_at/hold_out_command.hpp>
 # include <dismod_at/error_exit.hpp>
 # include <dismod_at/balance_pair.hpp>
+# include <dismod_at/counter_rng.hpp>
 # include <dismod_at/null_int.hpp>
 
 /*
@@ -37,6 +37,9 @@ that are included in subsequent fits.
 It is intended to make the initialization and fitting faster.
 The random sample of which values to include can be made repeatable using
 :ref:`option_table@random_seed` .
+The sample for each child (and the parent) uses its own
+:ref:`counter_rng-name` stream, determined by the random_seed,
+*integrand_name* , and the child.
 
 database
 ********
@@ -127,9 +130,9 @@ void hold_out_command(
    //
 
    //
-   // rng
-   // gsl random number generator
-   gsl_rng* rng = CppAD::mixed::get_gsl_rng();
+   // counter
+   // each child (and the parent) has its own random number stream
+   counter_rng counter;
    //
    // data_subset_table
    vector<data_subset_struct> data_subset_table = get_data_subset(db);
@@ -232,6 +235,11 @@ void hold_out_command(
       {   // hold out some data for this child
          n_fit += max_fit_child;
          //
+         // rng
+         gsl_rng* rng = counter.start(
+            hold_out_stream, size_t(this_integrand), child_id
+         );
+         //
          // n_hold_out
          size_t n_hold_out = avail_size[child_id] - max_fit_child;
          //
@@ -272,8 +280,11 @@ void hold_out_command(
             double cov_value = data_cov_value[index];
             pair_vec.push_back( pair_t( node_id, cov_value ) );
          }
+         gsl_rng* rng = counter.start(
+            hold_out_stream, size_t(this_integrand), child_id
+         );
          CppAD::vector<size_t> sample_vec = balance_pair(
-            max_fit_child, pair_vec, cov_value_1, cov_value_2
+            max_fit_child, pair_vec, cov_value_1, cov_value_2, rng
          );
          //
          // hold_out_vec
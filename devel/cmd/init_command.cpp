@@ -193,10 +193,12 @@ void init_command(
    // BEGIN_SORT_THIS_LINE_PLUS_2
    const char* drop_list[] = {
       "bnd_mulcov",
+      "cross_validate",
       "data_sim",
       "data_subset",
       "depend_var",
       "fit_data_subset",
+      "fit_hes",
       "fit_var",
       "hes_fixed",
       "hes_random",
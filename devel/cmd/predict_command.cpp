@@ -3,14 +3,16 @@
 // SPDX-FileContributor: 2014-22 Bradley M. Bell
 // ----------------------------------------------------------------------------
 
+# include <algorithm>
 # include <cppad/mixed/exception.hpp>
 # include <dismod_at/predict_command.hpp>
 # include <dismod_at/error_exit.hpp>
 # include <dismod_at/get_table_column.hpp>
 # include <dismod_at/get_sample_table.hpp>
 # include <dismod_at/exec_sql_cmd.hpp>
-# include <dismod_at/create_table.hpp>
+# include <dismod_at/table_writer.hpp>
 # include <dismod_at/censor_var_limit.hpp>
+# include <dismod_at/thread_pool.hpp>
 
 namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
 /*
@@ -68,6 +70,19 @@ In this case there is only one set of model variables that the
 predictions are computed for and
 :ref:`predict_table@sample_index` is always zero.
 
+n_thread
+********
+The samples are divided among the
+:ref:`option_table@n_thread` threads.
+The resulting predict table does not depend on the number of threads.
+
+Memory
+******
+The predictions are computed, and written to the predict table,
+for a limited number of samples at a time.
+Hence the memory used by this command does not grow with the
+number of samples.
+
 predict_table
 *************
 A new :ref:`predict_table-name` is created each time this command is run.
@@ -103,7 +118,6 @@ void predict_command(
 {
    using std::string;
    using CppAD::vector;
-   using CppAD::to_string;
    //
    if( source != "sample"
    &&  source != "fit_var"
@@ -161,8 +175,7 @@ void predict_command(
    table_name = "predict";
    size_t n_col      = 3;
    size_t n_subset   = avgint_subset_obj.size();
-   size_t n_row      = n_sample * n_subset;
-   vector<string> col_name(n_col), col_type(n_col), row_value(n_col * n_row);
+   vector<string> col_name(n_col), col_type(n_col);
    vector<bool>   col_unique(n_col);
    //
    col_name[0]   = "sample_index";
@@ -177,14 +190,41 @@ void predict_command(
    col_type[2]   = "real";
    col_unique[2] = false;
    //
-   // pack_vec
-   vector<double> pack_vec(n_var);
+   // n_chunk
+   // Number of samples computed before the corresponding rows are written.
+   // This bounds the memory used for the predictions; i.e., it does not
+   // grow with the number of samples.
+   size_t max_chunk_row = 100000;
+   size_t n_chunk       = max_chunk_row / std::max(n_subset, size_t(1));
+   n_chunk              = std::max(n_chunk, dismod_at::thread_pool_size());
+   n_chunk              = std::min(n_chunk, n_sample);
    //
-   size_t sample_id = 0;
-   for(size_t sample_index = 0; sample_index < n_sample; sample_index++)
-   {  // copy the variable values for this sample index into pack_vec
+   // writer
+   size_t n_commit = max_chunk_row;
+   dismod_at::table_writer writer(
+      db, table_name, col_name, col_type, col_unique, n_commit
+   );
+   //
+   // avg_chunk
+   // average integrand for each sample and subset in the current chunk
+   vector<double> avg_chunk(n_chunk * n_subset);
+   //
+   // error information for each sample in the current chunk
+   // (empty message for no error)
+   vector<string> error_message(n_chunk);
+   vector<bool>   error_avgint(n_chunk);
+   vector<int>    error_avgint_id(n_chunk);
+   //
+   // sample_job
+   // computes the predictions for one sample in the current chunk
+   size_t chunk_start = 0;
+   auto sample_job = [&](size_t chunk_index)
+   {  size_t sample_index = chunk_start + chunk_index;
+      //
+      // copy the variable values for this sample index into pack_vec
+      vector<double> pack_vec(n_var);
       for(size_t var_id = 0; var_id < n_var; var_id++)
-         pack_vec[var_id] = variable_value[sample_id++];
+         pack_vec[var_id] = variable_value[sample_index * n_var + var_id];
       //
       // censor samples to be within limits
       censor_var_limit(
@@ -194,37 +234,73 @@ void predict_command(
          db_input.prior_table
       );
       //
+      // cohort solutions are cached for this pack_vec (and this thread)
+      avgint_object.set_cohort_cache(true);
+      //
+      error_message[chunk_index] = "";
       for(size_t subset_id = 0; subset_id < n_subset; subset_id++)
-      {
-         int avgint_id  = avgint_subset_obj[subset_id].original_id;
-         double avg     = 0.0;
+      {  double avg = 0.0;
          try
          {  avg = avgint_object.average(subset_id, pack_vec);
          }
          catch(const std::exception& e)
-         {  string message("predict_command: std::exception: ");
-            message += e.what();
-            dismod_at::error_exit(message);
+         {  error_message[chunk_index]  = "predict_command: std::exception: ";
+            error_message[chunk_index] += e.what();
+            error_avgint[chunk_index]   = false;
+            avgint_object.set_cohort_cache(false);
+            return;
          }
          catch(const CppAD::mixed::exception& e)
-         {  string catcher    = "predict_command";
-            string message    = e.message(catcher);
-            table_name        = "avgint";
-            dismod_at::error_exit(message, table_name, avgint_id);
+         {  string catcher               = "predict_command";
+            error_message[chunk_index]   = e.message(catcher);
+            error_avgint[chunk_index]    = true;
+            error_avgint_id[chunk_index] =
+               avgint_subset_obj[subset_id].original_id;
+            avgint_object.set_cohort_cache(false);
+            return;
+         }
+         avg_chunk[chunk_index * n_subset + subset_id] = avg;
+      }
+      avgint_object.set_cohort_cache(false);
+   };
+   while( chunk_start < n_sample )
+   {  size_t n_job = std::min(n_chunk, n_sample - chunk_start);
+      dismod_at::thread_pool_run(n_job, sample_job);
+      //
+      // report the first error in sample order
+      for(size_t chunk_index = 0; chunk_index < n_job; chunk_index++)
+      {  if( error_message[chunk_index] != "" )
+         {  // predict table is not created when there is an error
+            writer.close();
+            dismod_at::exec_sql_cmd(db, sql_cmd);
+            if( error_avgint[chunk_index] )
+            {  table_name = "avgint";
+               dismod_at::error_exit(
+                  error_message[chunk_index],
+                  table_name,
+                  error_avgint_id[chunk_index]
+               );
+            }
+            dismod_at::error_exit( error_message[chunk_index] );
          }
-         //
-         size_t predict_id = sample_index * n_subset + subset_id;
-         if( source == "sample" )
-            row_value[n_col * predict_id + 0] = to_string( sample_index );
-         else
-            row_value[n_col * predict_id + 0] = "";
-         row_value[n_col * predict_id + 1] = to_string( avgint_id );
-         row_value[n_col * predict_id + 2] = to_string( avg );
       }
+      //
+      // write the rows for this chunk in sample order
+      for(size_t chunk_index = 0; chunk_index < n_job; chunk_index++)
+      {  size_t sample_index = chunk_start + chunk_index;
+         for(size_t subset_id = 0; subset_id < n_subset; subset_id++)
+         {  if( source == "sample" )
+               writer.set_integer(0, int(sample_index) );
+            else
+               writer.set_null(0);
+            writer.set_integer(1, avgint_subset_obj[subset_id].original_id);
+            writer.set_real(2, avg_chunk[chunk_index * n_subset + subset_id]);
+            writer.next_row();
+         }
+      }
+      chunk_start += n_job;
    }
-   dismod_at::create_table(
-      db, table_name, col_name, col_type, col_unique, row_value
-   );
+   writer.close();
    return;
 }
 } // END_DISMOD_AT_NAMESPACE
@@ -3,6 +3,10 @@
 // SPDX-FileContributor: 2014-22 Bradley M. Bell
 // ----------------------------------------------------------------------------
 
+# include <algorithm>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/wait.h>
 # include <dismod_at/sample_command.hpp>
 # include <dismod_at/error_exit.hpp>
 # include <dismod_at/exec_sql_cmd.hpp>
@@ -15,6 +19,12 @@
 # include <dismod_at/remove_const.hpp>
 # include <dismod_at/log_message.hpp>
 # include <dismod_at/get_str_map.hpp>
+# include <dismod_at/open_connection.hpp>
+# include <dismod_at/thread_pool.hpp>
+# include <dismod_at/blob_table.hpp>
+# include <dismod_at/does_table_exist.hpp>
+# include <dismod_at/pack_fit_hes.hpp>
+# include <dismod_at/fit_input_hash.hpp>
 
 
 namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
@@ -94,6 +104,16 @@ This requires running *number_sample* fits of the model variables
 See :ref:`posterior@Simulation` in the discussion of the
 posterior distribution of maximum likelihood estimates.
 
+n_thread
+========
+The fits for different values of *sample_index* are independent.
+If the :ref:`option_table@n_thread` option is greater
+than one, they are divided among *n_thread* separate processes
+(instead of threads because the optimizers are not thread safe).
+Each process uses its own connection to *database* for
+:ref:`log_table-name` messages.
+The results do not depend on *n_thread* .
+
 asymptotic
 **********
 If *method* is ``asymptotic`` ,
@@ -123,6 +143,25 @@ the scaled version of the fixed effect has the asymptotic distribution.
 If the lower and upper limits are equal, the corresponding variable
 is simulated as having that constant value.
 
+Fit Hessians
+============
+If *variables* is ``both`` ,
+the :ref:`fit_command@Output Tables@fit_hes` table exists,
+and it corresponds to the current :ref:`fit_var_table-name` ,
+*simulate_index* ,
+:ref:`option_table@Optimize Random Only@bound_random` , and
+:ref:`fit_input_hash@Tables` ,
+the Hessians in that table are used.
+Otherwise, the Hessians are computed at the values in the fit_var table.
+Using the fit_hes table avoids evaluating the Hessians a second time,
+which takes most of the time for this command when there are many
+model variables.
+This table is created by a fit command when the
+:ref:`option_table@save_fit_hes` option is ``true`` .
+If the options, priors, data, or data_subset table
+(e.g., a :ref:`hold_out_command-name` ) change after the fit,
+the fit_hes table is not used.
+
 Random Effects Distribution
 ===========================
 If the lower and upper limits for a random effect are equal,
@@ -162,6 +201,12 @@ which was created by a previous fit command which
 must have included :ref:`fit_command@variables@both`
 fixed and random effects.
 
+fit_hes_table
+=============
+If *method* is ``asymptotic`` ,
+this command may use the :ref:`fit_command@Output Tables@fit_hes`
+table; see :ref:`sample_command@asymptotic@Fit Hessians` .
+
 Output Tables
 *************
 
@@ -276,9 +321,13 @@ void sample_command(
    size_t n_col      = 3;
    size_t n_var      = pack_object.size();
    size_t n_row      = n_sample * n_var;
-   vector<string> col_name(n_col), col_type(n_col), row_value(n_col * n_row);
+   vector<string> col_name(n_col), col_type(n_col), row_value;
    vector<bool>   col_unique(n_col);
    //
+   // sample table integer columns (sample_index, var_id) and real column
+   vector<int>    int_value(2 * n_row);
+   vector<double> real_value(n_row);
+   //
    col_name[0]   = "sample_index";
    col_type[0]   = "integer";
    col_unique[0] = false;
@@ -422,18 +471,9 @@ void sample_command(
             }
          }
       }
-      // Vector used to replacement of the prior means:
-      // wor each variable it has a mean for value, dage and  dtime.
-      vector<double> prior_mean(n_var * 3);
-      //
-      // for each simulated data set
+      // check the data_sim table
       for(size_t sample_index = 0; sample_index < n_sample; sample_index++)
-      {  // --------------------------------------------------------------
-         // estimate fixed effects for this sample_index
-         // --------------------------------------------------------------
-         //
-         // replace data_sim_value in subset_data_obj
-         size_t offset = n_subset * sample_index;
+      {  size_t offset = n_subset * sample_index;
          for(size_t subset_id = 0; subset_id < n_subset; subset_id++)
          {  size_t data_sim_id = offset + subset_id;
             size_t sample_check =
@@ -447,6 +487,28 @@ void sample_command(
                table_name = "data_sim";
                dismod_at::error_exit(msg, table_name, data_sim_id);
             }
+         }
+      }
+      //
+      // Vector used to replacement of the prior means:
+      // wor each variable it has a mean for value, dage and  dtime.
+      vector<double> prior_mean(n_var * 3);
+      //
+      // fit_sample
+      // Fits the simulated data set for one sample_index and sets
+      // var_value[var_id] to the optimal value for each var_id.
+      // The database connection db_fit is used to log messages.
+      auto fit_sample = [&](
+         size_t sample_index, sqlite3* db_fit, double* var_value
+      )
+      {  // --------------------------------------------------------------
+         // estimate fixed effects for this sample_index
+         // --------------------------------------------------------------
+         //
+         // replace data_sim_value in subset_data_obj
+         size_t offset = n_subset * sample_index;
+         for(size_t subset_id = 0; subset_id < n_subset; subset_id++)
+         {  size_t data_sim_id = offset + subset_id;
 # ifndef NDEBUG
             double old_value = subset_data_obj[subset_id].data_sim_value;
 # endif
@@ -510,7 +572,7 @@ void sample_command(
          bool random_only   = false;
          int  sim_index_int = int(sample_index);
          dismod_at::fit_model fit_object_both(
-            db                   ,
+            db_fit               ,
             sim_index_int        ,
             warn_on_stderr       ,
             bound_random         ,
@@ -539,16 +601,10 @@ void sample_command(
          );
          assert( opt_value.size() == n_var );
          //
-         // solution for fixed effects and this sample_index -> row_value
-         string sample_index_str = to_string( sample_index );
+         // solution for fixed effects and this sample_index -> var_value
          for(size_t var_id = 0; var_id < n_var; var_id++)
          if( ! is_random_effect[var_id] )
-         {  size_t sample_id = sample_index * n_var + var_id;
-            row_value[n_col * sample_id + 0] = sample_index_str;
-            row_value[n_col * sample_id + 1] = to_string( var_id );
-            row_value[n_col * sample_id + 2] =
-               to_string(opt_value[var_id] );
-         }
+            var_value[var_id] = opt_value[var_id];
          // --------------------------------------------------------------
          // estimate random effects for this sample_index
          // --------------------------------------------------------------
@@ -576,7 +632,7 @@ void sample_command(
          // and then use the same fit_model object for random effects.
          random_only = true;
          dismod_at::fit_model fit_object_random(
-            db                   ,
+            db_fit               ,
             sim_index_int        ,
             warn_on_stderr       ,
             bound_random         ,
@@ -602,22 +658,118 @@ void sample_command(
          opt_value, lag_value, lag_dage, lag_dtime, trace_vec, warm_start_2
          );
          //
-         // solution for random effects and this sample_index -> row_value
+         // solution for random effects and this sample_index -> var_value
          for(size_t var_id = 0; var_id < n_var; var_id++)
          if( is_random_effect[var_id] )
+            var_value[var_id] = opt_value[var_id];
+      };
+      //
+      // sample_value
+      // sample_value[ sample_index * n_var + var_id ] is the optimal value
+      // for var_id when fitting the data set for sample_index.
+      vector<double> sample_value(n_sample * n_var);
+      //
+      // n_process
+      // The fits use cppad_mixed and Ipopt which are not thread safe,
+      // so the sample indices are divided among separate processes.
+      size_t n_thread  = dismod_at::thread_pool_size();
+      size_t n_process = std::min(n_thread, n_sample);
+      if( n_process == 1 )
+      {  for(size_t sample_index = 0; sample_index < n_sample; sample_index++)
+         {  double* var_value = sample_value.data() + sample_index * n_var;
+            fit_sample(sample_index, db, var_value);
+         }
+      }
+      else
+      {  // file name for the database
+         string file_name = sqlite3_db_filename(db, "main");
+         //
+         // The thread pool is not copied by fork, so it is freed here
+         // and re-created after the processes are done.
+         dismod_at::free_thread_pool();
+         //
+         // shared memory where the processes store their results
+         size_t n_byte = n_sample * (n_var * sizeof(double) + sizeof(int));
+         void*  shared = mmap(
+            nullptr, n_byte,
+            PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0
+         );
+         if( shared == MAP_FAILED )
+         {  msg = "sample_command: mmap failed for shared sample values";
+            dismod_at::error_exit(msg);
+         }
+         double* shared_value = reinterpret_cast<double*>(shared);
+         int*    shared_done  =
+            reinterpret_cast<int*>(shared_value + n_sample * n_var);
+         for(size_t sample_index = 0; sample_index < n_sample; sample_index++)
+            shared_done[sample_index] = 0;
+         //
+         // fork the processes
+         vector<pid_t> pid(n_process);
+         for(size_t p = 0; p < n_process; ++p)
+         {  pid[p] = fork();
+            if( pid[p] == 0 )
+            {  // This is a child process. It must not use the database
+               // connection of its parent, so it opens its own connection.
+               bool     new_file = false;
+               sqlite3* db_fit   =
+                  dismod_at::open_connection(file_name, new_file);
+               sqlite3_busy_timeout(db_fit, 60000);
+               dismod_at::error_exit(db_fit);
+               for(size_t sample_index = p;
+                  sample_index < n_sample; sample_index += n_process)
+               {  double* var_value = shared_value + sample_index * n_var;
+                  fit_sample(sample_index, db_fit, var_value);
+                  shared_done[sample_index] = 1;
+               }
+               sqlite3_close(db_fit);
+               _exit(0);
+            }
+            if( pid[p] < 0 )
+            {  msg = "sample_command: fork failed";
+               dismod_at::error_exit(msg);
+            }
+         }
+         //
+         // wait for the processes to finish
+         bool ok = true;
+         for(size_t p = 0; p < n_process; ++p)
+         {  int status;
+            waitpid(pid[p], &status, 0);
+            ok &= WIFEXITED(status) && WEXITSTATUS(status) == 0;
+         }
+         for(size_t sample_index = 0; sample_index < n_sample; sample_index++)
+            ok &= shared_done[sample_index] == 1;
+         //
+         // copy the results
+         for(size_t i = 0; i < n_sample * n_var; ++i)
+            sample_value[i] = shared_value[i];
+         munmap(shared, n_byte);
+         dismod_at::new_thread_pool(n_thread);
+         if( ! ok )
+         {  msg  = "sample_command: the fit for one of the samples failed;\n";
+            msg += "see the previous messages in the log table";
+            dismod_at::error_exit(msg);
+         }
+      }
+      //
+      // sample table
+      for(size_t sample_index = 0; sample_index < n_sample; sample_index++)
+      {  for(size_t var_id = 0; var_id < n_var; var_id++)
          {  size_t sample_id = sample_index * n_var + var_id;
-            row_value[n_col * sample_id + 0] = sample_index_str;
-            row_value[n_col * sample_id + 1] = to_string( var_id );
-            row_value[n_col * sample_id + 2] =
-               to_string(opt_value[var_id] );
+            int_value[0 * n_row + sample_id] = int( sample_index );
+            int_value[1 * n_row + sample_id] = int( var_id );
+            real_value[sample_id]            = sample_value[sample_id];
          }
       }
       table_name = "sample";
       dismod_at::create_table(
-         db, table_name, col_name, col_type, col_unique, row_value
+         db, table_name, col_name, col_type, col_unique,
+         n_row, int_value, real_value
       );
       return;
    }
+
    // ----------------------------------------------------------------------
    assert( method == "asymptotic" );
    //
@@ -689,8 +841,57 @@ void sample_command(
       trace_init
    );
    //
-   // hes_fixed_obj_out, hes_random_obj_out, sample_out
+   // hes_fixed_obj_out, hes_random_obj_out
+   // If the fit_hes table corresponds to this sample, use its Hessians.
+   // (The fit_hes table is written by fit both. In the fixed case the
+   // random effects are constants and the fixed objective is different.)
    CppAD::mixed::d_sparse_rcv hes_fixed_obj_out, hes_random_obj_out;
+   bool use_fit_hes = variables == "both";
+   use_fit_hes     &= dismod_at::does_table_exist(db, "fit_hes");
+   if( use_fit_hes )
+   {  // get sizeof_data
+      table_name         = "fit_hes";
+      string col_name    = "fit_hes";
+      size_t sizeof_data = 0;
+      void* data         = nullptr;
+      dismod_at::read_blob_table(db, table_name, col_name, sizeof_data, data);
+      //
+      // read the data
+      assert( sizeof_data % sizeof(double) == 0 );
+      vector<double> vec( sizeof_data / sizeof(double) );
+      data = reinterpret_cast<void*>( vec.data() );
+      dismod_at::read_blob_table(db, table_name, col_name, sizeof_data, data);
+      //
+      int                        fit_sim_index;
+      double                     fit_bound_random;
+      double                     fit_input_hash;
+      vector<double>             fit_hes_var;
+      CppAD::mixed::d_sparse_rcv fit_hes_fixed, fit_hes_random;
+      dismod_at::unpack_fit_hes(
+         vec,
+         fit_sim_index,
+         fit_bound_random,
+         fit_input_hash,
+         fit_hes_var,
+         fit_hes_fixed,
+         fit_hes_random
+      );
+      //
+      // check that the fit inputs and fit_var have not changed
+      // since the fit_hes table was written
+      bool same = fit_sim_index == sim_index_int;
+      same     &= fit_bound_random == bound_random;
+      same     &= fit_input_hash == dismod_at::fit_input_hash(db, option_map);
+      same     &= fit_hes_var.size() == n_var;
+      for(size_t i = 0; i < n_var && same; ++i)
+         same &= fit_hes_var[i] == fit_var_value[i];
+      if( same )
+      {  hes_fixed_obj_out  = fit_hes_fixed;
+         hes_random_obj_out = fit_hes_random;
+      }
+   }
+   //
+   // sample_out
    vector<double> sample_out;
    fit_object.sample_posterior(
       hes_fixed_obj_out    ,
@@ -706,19 +907,17 @@ void sample_command(
    if( sample_out.size() != 0 )
    {  assert( sample_out.size() == n_sample * n_var );
       for(size_t sample_index = 0; sample_index < n_sample; sample_index++)
-      {  string sample_index_str = to_string( sample_index );
-         for(size_t var_id = 0; var_id < n_var; var_id++)
+      {  for(size_t var_id = 0; var_id < n_var; var_id++)
          {  size_t sample_id = sample_index * n_var + var_id;
-            row_value[n_col * sample_id + 0] = sample_index_str;
-            row_value[n_col * sample_id + 1] = to_string( var_id );
-            //
-            double var_value = sample_out[ sample_index * n_var + var_id];
-            row_value[n_col * sample_id + 2] = to_string(var_value);
+            int_value[0 * n_row + sample_id] = int( sample_index );
+            int_value[1 * n_row + sample_id] = int( var_id );
+            real_value[sample_id]            = sample_out[sample_id];
          }
       }
       table_name = "sample";
       dismod_at::create_table(
-         db, table_name, col_name, col_type, col_unique, row_value
+         db, table_name, col_name, col_type, col_unique,
+         n_row, int_value, real_value
       );
    }
    // ----------------------------------------------------------------------
@@ -3,6 +3,8 @@
 // SPDX-FileContributor: 2014-23 Bradley M. Bell
 // ----------------------------------------------------------------------------
 
+# include <limits>
+# include <stdexcept>
 # include <dismod_at/simulate_command.hpp>
 # include <dismod_at/error_exit.hpp>
 # include <dismod_at/get_table_column.hpp>
@@ -12,6 +14,8 @@
 # include <dismod_at/null_int.hpp>
 # include <dismod_at/get_density_table.hpp>
 # include <dismod_at/meas_noise_effect.hpp>
+# include <dismod_at/counter_rng.hpp>
+# include <dismod_at/thread_pool.hpp>
 
 namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
 /*
@@ -66,6 +70,23 @@ It contains *number_simulate* values
 for each :ref:`var_table@var_id` in the var table.
 Hence the number of rows in :ref:`data_sim_table-name` is
 *number_simulate* times the number of rows in :ref:`var_table-name` .
+
+Random Numbers
+**************
+Each simulated value uses its own :ref:`counter_rng-name` stream.
+The stream for a :ref:`data_sim_table-name` value is determined by the
+:ref:`option_table@random_seed` , *simulate_index* , and
+:ref:`data_table@data_id` .
+The stream for a :ref:`prior_sim_table-name` value is determined by the
+random_seed, *simulate_index* , and :ref:`var_table@var_id` .
+Hence the simulated values do not depend on the order in which they
+are computed.
+
+n_thread
+========
+The simulations for different measurements (and different variables)
+are divided among the :ref:`option_table@n_thread` threads.
+The results do not depend on *n_thread* .
 {xrst_toc_hidden
    example/get_started/simulate_command.py
 }
@@ -91,7 +112,6 @@ void simulate_command(
 {
    using std::string;
    using CppAD::vector;
-   using CppAD::to_string;
    //
    const vector<prior_struct>&     prior_table( db_input.prior_table );
    const vector<density_enum>&     density_table( db_input.density_table );
@@ -119,9 +139,13 @@ void simulate_command(
    size_t n_col    = 3;
    size_t n_subset = subset_data_obj.size();
    size_t n_row    = n_simulate * n_subset;
-   vector<string> col_name(n_col), col_type(n_col), row_value(n_col * n_row);
+   vector<string> col_name(n_col), col_type(n_col);
    vector<bool>   col_unique(n_col);
    //
+   // integer columns (simulate_index, data_subset_id) and real column
+   vector<int>    int_value(2 * n_row);
+   vector<double> real_value(n_row);
+   //
    col_name[0]   = "simulate_index";
    col_type[0]   = "integer";
    col_unique[0] = false;
@@ -134,15 +158,9 @@ void simulate_command(
    col_type[2]   = "real";
    col_unique[2] = false;
    //
-   // for each measurement in the data_subset table
+   // check for densities that cannot be simulated
    for(size_t subset_id = 0; subset_id < n_subset; subset_id++)
-   {
-      //
-      // compute the average integrand, avg
-      double avg = data_object.average(subset_id, truth_var);
-      //
-      // density corresponding to this data point
-      density_enum density = subset_data_obj[subset_id].density;
+   {  density_enum density = subset_data_obj[subset_id].density;
       assert( density != uniform_enum );
       if( density == binomial_enum )
       {  msg           = "dismod_at simulate command: ";
@@ -151,29 +169,55 @@ void simulate_command(
          size_t row_id = subset_data_obj[subset_id].original_id;
          error_exit(msg, table_name, row_id);
       }
+   }
+   //
+   // data_sim_job
+   // simulates all the values for one measurement in the data_subset table
+   auto data_sim_job = [&](size_t subset_id)
+   {  //
+      // compute the average integrand, avg
+      double avg = data_object.average(subset_id, truth_var);
+      //
+      // density corresponding to this data point
+      density_enum density = subset_data_obj[subset_id].density;
       //
       // data table information
       double eta          = subset_data_obj[subset_id].eta;
       double nu           = subset_data_obj[subset_id].nu;
+      size_t data_id      = subset_data_obj[subset_id].original_id;
       //
       // data table adjusted standard deviation, delta
       double delta;
       data_object.like_one(subset_id, truth_var, avg, delta);
       //
+      counter_rng counter;
       for(size_t sim_index = 0; sim_index < n_simulate; sim_index++)
       {  // for each simulate_index
          //
          // sim_value
-         double sim_value   = sim_random(density, avg, delta, eta, nu);
+         gsl_rng* rng     = counter.start(data_sim_stream, sim_index, data_id);
+         double sim_value = sim_random(rng, density, avg, delta, eta, nu);
          //
          size_t data_sim_id = sim_index * n_subset + subset_id;
-         row_value[data_sim_id * n_col + 0] = to_string( sim_index );
-         row_value[data_sim_id * n_col + 1] = to_string( subset_id );
-         row_value[data_sim_id * n_col + 2] = to_string( sim_value );
+         int_value[0 * n_row + data_sim_id] = int( sim_index );
+         int_value[1 * n_row + data_sim_id] = int( subset_id );
+         real_value[data_sim_id]            = sim_value;
       }
+   };
+   // cohort solutions are cached for truth_var
+   data_object.set_cohort_cache(true);
+   //
+   // like_one errors detected in parallel mode are reported here
+   try
+   {  thread_pool_run(n_subset, data_sim_job);
+   }
+   catch(const std::runtime_error& e)
+   {  error_exit( e.what() );
    }
+   data_object.set_cohort_cache(false);
    create_table(
-      db, table_name, col_name, col_type, col_unique, row_value
+      db, table_name, col_name, col_type, col_unique,
+      n_row, int_value, real_value
    );
    // ----------------- prior_sim_table ----------------------------------
    sql_cmd = "drop table if exists prior_sim";
@@ -186,7 +230,11 @@ void simulate_command(
    col_name.resize(n_col);
    col_type.resize(n_col);
    col_unique.resize(n_col);
-   row_value.resize(n_col * n_row);
+   //
+   // integer columns (simulate_index, var_id) and
+   // real columns (prior_sim_value, prior_sim_dage, prior_sim_dtime)
+   int_value.resize(2 * n_row);
+   real_value.resize(3 * n_row);
    //
    col_name[0]   = "simulate_index";
    col_type[0]   = "integer";
@@ -205,28 +253,36 @@ void simulate_command(
    }
    // -----------------------------------------------------------------------
    // simulate value for mean of prior for each variable in the var table
+   double nan = std::numeric_limits<double>::quiet_NaN();
    vector<double> sim_prior_value(n_simulate * n_var);
-   for(size_t var_id = 0; var_id < n_var; ++var_id)
+   //
+   // prior_sim_job
+   // simulates all the values for one variable in the var table
+   auto prior_sim_job = [&](size_t var_id)
    {  //
+      // counter
+      counter_rng counter;
+      //
       // prior id for mean of this this variable
       size_t prior_id[3];
-      vector<string> sim_str(3);
+      double sim_prior[3];
       prior_id[0]        = var2prior.value_prior_id(var_id);
       prior_id[1]        = var2prior.dage_prior_id(var_id);
       prior_id[2]        = var2prior.dtime_prior_id(var_id);
       double const_value = var2prior.const_value(var_id);
       for(size_t sim_index = 0; sim_index < n_simulate; sim_index++)
-      {  for(size_t k = 0; k < 3; ++k)
+      {  gsl_rng* rng = counter.start(prior_sim_stream, sim_index, var_id);
+         for(size_t k = 0; k < 3; ++k)
          if( k == 0 && ! std::isnan(const_value) )
          {  assert( prior_id[k] == DISMOD_AT_NULL_SIZE_T );
             sim_prior_value[sim_index * n_var + var_id] = const_value;
-            sim_str[0] = to_string(const_value);
+            sim_prior[0] = const_value;
          }
          else if( prior_id[k] == DISMOD_AT_NULL_SIZE_T )
          {  assert( k != 0 );
             // The default prior is a uniform on [-inf, +inf]
             // cannot simulate from this distribution
-            sim_str[k] = "null";
+            sim_prior[k] = nan;
          }
          else
          {  double lower = prior_table[ prior_id[k] ].lower;
@@ -241,14 +297,14 @@ void simulate_command(
             //
             assert( density != binomial_enum );
             if( density == uniform_enum )
-               sim_str[k] = "null";
+               sim_prior[k] = nan;
             else
-            {  double sim = sim_random(density, mean, std, eta, nu);
+            {  double sim = sim_random(rng, density, mean, std, eta, nu);
                //
                sim = std::min(sim, upper);
                sim = std::max(sim, lower);
                //
-               sim_str[k] = to_string( sim );
+               sim_prior[k] = sim;
                //
                // store value prior for later use by zero sum constraints
                if( k == 0 )
@@ -257,13 +313,14 @@ void simulate_command(
          }
          //
          size_t prior_sim_id = sim_index * n_var + var_id;
-         row_value[prior_sim_id * n_col + 0] = to_string( sim_index );
-         row_value[prior_sim_id * n_col + 1] = to_string( var_id );
-         row_value[prior_sim_id * n_col + 2] = sim_str[0];
-         row_value[prior_sim_id * n_col + 3] = sim_str[1];
-         row_value[prior_sim_id * n_col + 4] = sim_str[2];
+         int_value[0 * n_row + prior_sim_id]  = int( sim_index );
+         int_value[1 * n_row + prior_sim_id]  = int( var_id );
+         real_value[0 * n_row + prior_sim_id] = sim_prior[0];
+         real_value[1 * n_row + prior_sim_id] = sim_prior[1];
+         real_value[2 * n_row + prior_sim_id] = sim_prior[2];
       }
-   }
+   };
+   thread_pool_run(n_var, prior_sim_job);
    // ----------------------------------------------------------------------
    // Enforce zero_sum_child_rate contraints
    //
@@ -331,7 +388,7 @@ void simulate_command(
                size_t prior_sim_id = sim_index * n_var + var_id;
                //
                // overwrite the value prior to be zero mean
-               row_value[prior_sim_id * n_col + 2] = to_string(value);
+               real_value[prior_sim_id] = value;
             }
          }
       }
@@ -443,7 +500,7 @@ void simulate_command(
                   size_t prior_sim_id = sim_index * n_var + var_id;
                   //
                   // overwrite the value prior to be zero mean
-                  row_value[prior_sim_id * n_col + 2] = to_string(value);
+                  real_value[prior_sim_id] = value;
                }
             }
          }
@@ -452,7 +509,8 @@ void simulate_command(
    // ------------------------------------------------------------------------
    // create prior_sim table
    create_table(
-      db, table_name, col_name, col_type, col_unique, row_value
+      db, table_name, col_name, col_type, col_unique,
+      n_row, int_value, real_value
    );
    return;
 }
@@ -20,8 +20,10 @@
 # include <dismod_at/child_data_in_fit.hpp>
 # include <dismod_at/child_info.hpp>
 # include <dismod_at/configure.hpp>
+# include <dismod_at/counter_rng.hpp>
 # include <dismod_at/cov2weight_map.hpp>
 # include <dismod_at/create_table.hpp>
+# include <dismod_at/cross_validate_command.hpp>
 # include <dismod_at/data_density_command.hpp>
 # include <dismod_at/depend.hpp>
 # include <dismod_at/depend_command.hpp>
@@ -45,6 +47,7 @@
 # include <dismod_at/log_message.hpp>
 # include <dismod_at/min_max_vector.hpp>
 # include <dismod_at/null_int.hpp>
+# include <dismod_at/ode2_chkpoint.hpp>
 # include <dismod_at/old2new_command.hpp>
 # include <dismod_at/open_connection.hpp>
 # include <dismod_at/pack_info.hpp>
@@ -54,6 +57,7 @@
 # include <dismod_at/set_command.hpp>
 # include <dismod_at/sim_random.hpp>
 # include <dismod_at/simulate_command.hpp>
+# include <dismod_at/thread_pool.hpp>
 // END_SORT_THIS_LINE_MINUS_1
 
 # define DISMOD_AT_TRACE 0
@@ -71,6 +75,7 @@ int main(int n_arg, const char** argv)
    struct { const char* name; int n_arg; } command_info[] = {
       {"bnd_mulcov",   4},
       {"bnd_mulcov",   5},
+      {"cross_validate", 4},
       {"data_density", 3},
       {"data_density", 7},
       {"depend",       3},
@@ -229,6 +234,15 @@ int main(int n_arg, const char** argv)
       option_map[name] = value;
    }
    // ---------------------------------------------------------------------
+   // trace_db_input
+   if( option_map["trace_db_input"] == "true" )
+   {  for(const auto& pair : db_input.table_seconds)
+      {  message  = "get_db_input: " + pair.first + " seconds = ";
+         message += CppAD::to_string( pair.second );
+         dismod_at::log_message(db, DISMOD_AT_NULL_PTR, "value", message);
+      }
+   }
+   // ---------------------------------------------------------------------
    // ode_step_size
    double ode_step_size  = std::atof( option_map["ode_step_size"].c_str() );
    assert( ode_step_size > 0.0 );
@@ -253,6 +267,26 @@ int main(int n_arg, const char** argv)
       CppAD::mixed::new_gsl_rng(random_seed);
 # endif
    }
+   // counter based random number streams use the same seed
+   if( random_seed == 0 )
+      dismod_at::set_counter_seed( size_t(unix_time) );
+   else
+      dismod_at::set_counter_seed(random_seed);
+   // ------------------------------------------------------------------------
+   // thread pool (must be created before any data_model objects)
+   size_t n_thread = std::atoi( option_map["n_thread"].c_str() );
+   assert( n_thread > 0 );
+   if( n_thread > CPPAD_MAX_NUM_THREADS )
+   {  message  = "option table: n_thread = " + option_map["n_thread"];
+      message += " is greater than CPPAD_MAX_NUM_THREADS = ";
+      message += CppAD::to_string( CPPAD_MAX_NUM_THREADS );
+      dismod_at::error_exit(message);
+   }
+   dismod_at::new_thread_pool(n_thread);
+   // ------------------------------------------------------------------------
+   // ODE step checkpoint functions (must be created before any a1_double
+   // recording; e.g., by the depend, fit, or sample commands)
+   dismod_at::ode2_chkpoint_setup();
    // ------------------------------------------------------------------------
    // check for init_command output tables
    const char* init_table_name[] = {
@@ -411,6 +445,22 @@ int main(int n_arg, const char** argv)
    // rate_case
    string rate_case = option_map["rate_case"];
    //
+   // ode_tolerance
+   double ode_tolerance = 0.0;
+   if( option_map["ode_tolerance"] != "" )
+      ode_tolerance = std::atof( option_map["ode_tolerance"].c_str() );
+   if( ode_tolerance > 0.0 )
+   {  // commands that record the objective as a function of the rates
+      bool record = command_arg == "depend" || command_arg == "fit";
+      record     |= command_arg == "sample";
+      record     |= command_arg == "cross_validate";
+      if( record )
+      {  message  = "ode_tolerance is not empty and command is ";
+         message += command_arg;
+         dismod_at::error_exit(message);
+      }
+   }
+   //
    // age_avg_split
    string age_avg_split = option_map["age_avg_split"];
    //
@@ -608,6 +658,7 @@ int main(int n_arg, const char** argv)
          fit_simulated_data       ,
          meas_noise_effect        ,
          rate_case                ,
+         ode_tolerance            ,
          bound_random             ,
          ode_step_size            ,
          age_avg_grid             ,
@@ -693,6 +744,7 @@ int main(int n_arg, const char** argv)
          fit_simulated_data       ,
          meas_noise_effect        ,
          rate_case                ,
+         ode_tolerance            ,
          bound_random             ,
          ode_step_size            ,
          age_avg_grid             ,
@@ -752,6 +804,20 @@ int main(int n_arg, const char** argv)
             option_map
          );
       }
+      else if( command_arg == "cross_validate" )
+      {  string n_fold = argv[3];
+         cross_validate_command(
+            n_fold           ,
+            db               ,
+            subset_data_obj  ,
+            data_object      , // not  const
+            prior_object     ,
+            pack_object      ,
+            var2prior        ,
+            db_input         ,
+            option_map
+         );
+      }
       else if( command_arg == "simulate" )
       {  // replace_like
          data_object.replace_like(subset_data_obj );
@@ -811,6 +877,7 @@ int main(int n_arg, const char** argv)
 # endif
    // =======================================================================
    // ---------------------------------------------------------------------
+   dismod_at::free_thread_pool();
    message = "end " + command_arg;
    dismod_at::log_message(db, DISMOD_AT_NULL_PTR, "command", message);
    sqlite3_close(db);
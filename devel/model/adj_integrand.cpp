@@ -2,6 +2,7 @@
 // SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
 // SPDX-FileContributor: 2014-23 Bradley M. Bell
 // ----------------------------------------------------------------------------
+# include <map>
 # include <cppad/mixed/exception.hpp>
 # include <dismod_at/adj_integrand.hpp>
 # include <dismod_at/null_int.hpp>
@@ -35,6 +36,7 @@ Syntax
 | |tab| *cov2weight_obj*,
 | |tab| *w_info_vec*,
 | |tab| *rate_case* ,
+| |tab| *ode_tolerance* ,
 | |tab| *age_table* ,
 | |tab| *time_table* ,
 | |tab| *covariate_table* ,
@@ -43,6 +45,7 @@ Syntax
 | |tab| *s_info_vec* ,
 | |tab| *pack_object*
 | );
+| ``adj_integrand::work_struct`` *work*
 | *adj_line* = *adjint_obj* . ``line`` (
 | |tab| *node_id* ,
 | |tab| *line_age* ,
@@ -52,7 +55,8 @@ Syntax
 | |tab| *child* ,
 | |tab| *subgroup_id* ,
 | |tab| *x* ,
-| |tab| *pack_vec*
+| |tab| *pack_vec* ,
+| |tab| *work*
 | )
 
 Prototype
@@ -85,6 +89,12 @@ rate_case
 This is the value of
 :ref:`option_table@rate_case` in the option table.
 
+ode_tolerance
+*************
+This is the value of
+:ref:`option_table@ode_tolerance` in the option table
+(zero if it is empty); see :ref:`cohort_ode@ode_tolerance` .
+
 age_table
 *********
 This argument is the :ref:`age_table-name` .
@@ -134,9 +144,6 @@ identifies the node for this adjustment.
 line_age
 ********
 This vector is the age points at which the adjusted integrand is computed.
-It is faster if successive points have close values in age; e.g.,
-
-   *line_age* [ *k* ] <= *line_age* [ *k* +1]
 
 n_line
 ======
@@ -147,9 +154,6 @@ line_time
 *********
 This vector has size *n_line* and is
 the time points at which the adjusted integrand is computed.
-It is faster if successive points have close values in time; e.g.,
-
-   *line_time* [ *k* ] >= *line_time* [ *k* +1]
 
 ODE
 ===
@@ -205,6 +209,20 @@ Float
 The type *Float* must be ``double`` or
 :ref:`a1_double-name` .
 
+work
+****
+This is work space used by ``line`` to avoid re-allocating memory
+between calls. Its input value does not matter and its output value
+is unspecified.
+Smoothing and weighting grids that have the same age and time values
+share one :ref:`grid2line_stencil-name` in *work* .
+Each such stencil is computed at most once per call to ``line``
+and then used for all the rates, covariate multipliers, and covariates
+that are interpolated to the line.
+The *adjint_obj* is not changed by ``line`` ,
+hence it can be shared by multiple threads provided that each
+thread uses its own *work* .
+
 adj_line
 ********
 The return value is a vector with size *n_line*
@@ -230,6 +248,7 @@ adj_integrand::adj_integrand(
    const cov2weight_map&                     cov2weight_obj   ,
    const CppAD::vector<weight_info>&         w_info_vec       ,
    const std::string&                        rate_case        ,
+   double                                    ode_tolerance    ,
    const CppAD::vector<double>&              age_table        ,
    const CppAD::vector<double>&              time_table       ,
    const CppAD::vector<covariate_struct>&    covariate_table  ,
@@ -240,7 +259,8 @@ adj_integrand::adj_integrand(
    const pack_info&                          pack_object      )
 // END_ADJ_INTEGRAND_PROTOTYPE
 :
-rate_case_         (rate_case)        ,
+case_number_       ( cohort_ode_case_number(rate_case) ) ,
+ode_tolerance_     (ode_tolerance)    ,
 age_table_         (age_table)        ,
 time_table_        (time_table)       ,
 covariate_table_    (covariate_table) ,
@@ -249,9 +269,7 @@ integrand_table_   (integrand_table)  ,
 s_info_vec_        (s_info_vec)       ,
 pack_object_       (pack_object)      ,
 cov2weight_obj_    (cov2weight_obj)   ,
-w_info_vec_        (w_info_vec)       ,
-double_rate_       (number_rate_enum) ,
-a1_double_rate_    (number_rate_enum)
+w_info_vec_        (w_info_vec)
 {  // set mulcov_pack_info_
    size_t n_integrand = integrand_table.size();
    mulcov_pack_info_.resize( mulcov_table.size() );
@@ -304,6 +322,103 @@ a1_double_rate_    (number_rate_enum)
       }
       assert( mulcov_pack_info_[mulcov_id].smooth_id == size_t(smooth_id) );
    }
+   //
+   // n_grid_class_, smooth_grid_class_, weight_grid_class_
+   typedef std::pair< std::vector<size_t>, std::vector<size_t> > grid_key;
+   std::map<grid_key, size_t> grid_class_map;
+   n_grid_class_ = 0;
+   smooth_grid_class_.resize( s_info_vec.size() );
+   for(size_t smooth_id = 0; smooth_id < s_info_vec.size(); ++smooth_id)
+   {  const smooth_info& s_info = s_info_vec[smooth_id];
+      grid_key key;
+      for(size_t i = 0; i < s_info.age_size(); ++i)
+         key.first.push_back( s_info.age_id(i) );
+      for(size_t j = 0; j < s_info.time_size(); ++j)
+         key.second.push_back( s_info.time_id(j) );
+      auto itr = grid_class_map.insert( {key, n_grid_class_} ).first;
+      if( itr->second == n_grid_class_ )
+         ++n_grid_class_;
+      smooth_grid_class_[smooth_id] = itr->second;
+   }
+   weight_grid_class_.resize( w_info_vec.size() );
+   for(size_t weight_id = 0; weight_id < w_info_vec.size(); ++weight_id)
+   {  const weight_info& w_info = w_info_vec[weight_id];
+      grid_key key;
+      for(size_t i = 0; i < w_info.age_size(); ++i)
+         key.first.push_back( w_info.age_id(i) );
+      for(size_t j = 0; j < w_info.time_size(); ++j)
+         key.second.push_back( w_info.time_id(j) );
+      auto itr = grid_class_map.insert( {key, n_grid_class_} ).first;
+      if( itr->second == n_grid_class_ )
+         ++n_grid_class_;
+      weight_grid_class_[weight_id] = itr->second;
+   }
+}
+
+// work_struct
+adj_integrand::work_struct::work_struct(void)
+:
+double_rate       (number_rate_enum) ,
+a1_double_rate    (number_rate_enum)
+{ }
+
+// line_stencil
+template <class Grid_info>
+const grid2line_stencil& adj_integrand::line_stencil(
+   size_t                                             grid_class       ,
+   const Grid_info&                                   g_info           ,
+   const CppAD::vector<double>&                       line_age         ,
+   const CppAD::vector<double>&                       line_time        ,
+   work_struct&                                       work             ) const
+{  assert( grid_class < n_grid_class_ );
+   if( ! work.stencil_ok[grid_class] )
+   {  work.stencil[grid_class].set(
+         line_age, line_time, age_table_, time_table_, g_info
+      );
+      work.stencil_ok[grid_class] = true;
+   }
+   assert( work.stencil[grid_class].size() == line_age.size() );
+   return work.stencil[grid_class];
+}
+
+// smooth2line
+template <class Float>
+void adj_integrand::smooth2line(
+   size_t                                             smooth_id        ,
+   const CppAD::vector<double>&                       line_age         ,
+   const CppAD::vector<double>&                       line_time        ,
+   const CppAD::vector<Float>&                        grid_value       ,
+   CppAD::vector<Float>&                              line_value       ,
+   work_struct&                                       work             ) const
+{  const grid2line_stencil& stencil = line_stencil(
+      smooth_grid_class_[smooth_id],
+      s_info_vec_[smooth_id],
+      line_age,
+      line_time,
+      work
+   );
+   line_value.resize( line_age.size() );
+   stencil.eval(grid_value, line_value);
+}
+
+// weight2line
+template <class Float>
+void adj_integrand::weight2line(
+   size_t                                             weight_id        ,
+   const CppAD::vector<double>&                       line_age         ,
+   const CppAD::vector<double>&                       line_time        ,
+   const CppAD::vector<Float>&                        grid_value       ,
+   CppAD::vector<Float>&                              line_value       ,
+   work_struct&                                       work             ) const
+{  const grid2line_stencil& stencil = line_stencil(
+      weight_grid_class_[weight_id],
+      w_info_vec_[weight_id],
+      line_age,
+      line_time,
+      work
+   );
+   line_value.resize( line_age.size() );
+   stencil.eval(grid_value, line_value);
 }
 
 // BEGIN_LINE_PROTOTYPE
@@ -320,9 +435,16 @@ CppAD::vector<Float> adj_integrand::line(
    const CppAD::vector<Float>&                        pack_vec         ,
 // END_LINE_PROTOTYPE
    CppAD::vector<Float>&                              mulcov           ,
-   CppAD::vector< CppAD::vector<Float> >&             rate             )
+   CppAD::vector< CppAD::vector<Float> >&             rate             ,
+   work_struct&                                       work             ) const
 {  using CppAD::vector;
    //
+   // stencils are only valid for this line_age and line_time
+   work.stencil.resize(n_grid_class_);
+   work.stencil_ok.resize(n_grid_class_);
+   for(size_t grid_class = 0; grid_class < n_grid_class_; ++grid_class)
+      work.stencil_ok[grid_class] = false;
+   //
    // some temporaries
    pack_info::subvec_info info;
    vector<Float> smooth_value;
@@ -421,14 +543,13 @@ CppAD::vector<Float> adj_integrand::line(
          smooth_value.resize(info.n_var);
          for(size_t k = 0; k < info.n_var; ++k)
             smooth_value[k] = pack_vec[info.offset + k];
-         const smooth_info& s_info = s_info_vec_[smooth_id];
-         mulcov = grid2line(
+         smooth2line(
+            smooth_id,
             line_age,
             line_time,
-            age_table_,
-            time_table_,
-            s_info,
-            smooth_value
+            smooth_value,
+            mulcov,
+            work
          );
       }
       return mulcov;
@@ -453,14 +574,13 @@ CppAD::vector<Float> adj_integrand::line(
          smooth_value.resize(info.n_var);
          for(size_t k = 0; k < info.n_var; ++k)
             smooth_value[k] = pack_vec[info.offset + k];
-         const smooth_info& s_info = s_info_vec_[smooth_id];
-         rate[rate_id] = grid2line(
+         smooth2line(
+            smooth_id,
             line_age,
             line_time,
-            age_table_,
-            time_table_,
-            s_info,
-            smooth_value
+            smooth_value,
+            rate[rate_id],
+            work
          );
       }
       //
@@ -478,16 +598,15 @@ CppAD::vector<Float> adj_integrand::line(
             smooth_value.resize(info.n_var);
             for(size_t k = 0; k < info.n_var; ++k)
                smooth_value[k] = pack_vec[info.offset + k];
-            const smooth_info& s_info = s_info_vec_[smooth_id];
             //
             // temp_1 = child random effect
-            temp_1 = grid2line(
+            smooth2line(
+               smooth_id,
                line_age,
                line_time,
-               age_table_,
-               time_table_,
-               s_info,
-               smooth_value
+               smooth_value,
+               temp_1,
+               work
             );
             for(size_t k = 0; k < n_line; ++k)
                effect[k] += temp_1[k];
@@ -504,16 +623,15 @@ CppAD::vector<Float> adj_integrand::line(
             smooth_value.resize(info.n_var);
             for(size_t k = 0; k < info.n_var; ++k)
                smooth_value[k] = pack_vec[info.offset + k];
-            const smooth_info& s_info = s_info_vec_[smooth_id];
             //
             // temp_1 = covariate multiplier fixed effect
-            temp_1 = grid2line(
+            smooth2line(
+               smooth_id,
                line_age,
                line_time,
-               age_table_,
-               time_table_,
-               s_info,
-               smooth_value
+               smooth_value,
+               temp_1,
+               work
             );
             //
             // temp_2 = covariate value
@@ -536,13 +654,13 @@ CppAD::vector<Float> adj_integrand::line(
                      cov_grid[i * n_time + ell] =
                         w_info.weight(i, ell) - reference;
                }
-               temp_2 = grid2line(
+               weight2line(
+                  weight_id,
                   line_age,
                   line_time,
-                  age_table_,
-                  time_table_,
-                  w_info,
-                  cov_grid
+                  cov_grid,
+                  temp_2,
+                  work
                );
             }
             for(size_t k = 0; k < n_line; ++k)
@@ -563,16 +681,15 @@ CppAD::vector<Float> adj_integrand::line(
             smooth_value.resize(info.n_var);
             for(size_t ell = 0; ell < info.n_var; ++ell)
                smooth_value[ell] = pack_vec[info.offset + ell];
-            const smooth_info& s_info = s_info_vec_[smooth_id];
             //
             // temp_1 = covariate multiplier random effect
-            temp_1 = grid2line(
+            smooth2line(
+               smooth_id,
                line_age,
                line_time,
-               age_table_,
-               time_table_,
-               s_info,
-               smooth_value
+               smooth_value,
+               temp_1,
+               work
             );
             //
             // temp_2 = covariate value
@@ -595,13 +712,13 @@ CppAD::vector<Float> adj_integrand::line(
                      cov_grid[i * n_time + ell] =
                         w_info.weight(i, ell) - reference;
                }
-               temp_2 = grid2line(
+               weight2line(
+                  weight_id,
                   line_age,
                   line_time,
-                  age_table_,
-                  time_table_,
-                  w_info,
-                  cov_grid
+                  cov_grid,
+                  temp_2,
+                  work
                );
             }
             for(size_t ell = 0; ell < n_line; ++ell)
@@ -631,7 +748,8 @@ CppAD::vector<Float> adj_integrand::line(
 # endif
       Float pini = rate[pini_enum][0];
       cohort_ode(
-         rate_case_,
+         case_number_,
+         ode_tolerance_,
          line_age,
          pini,
          rate[iota_enum],
@@ -779,16 +897,15 @@ CppAD::vector<Float> adj_integrand::line(
          smooth_value.resize(info.n_var);
          for(size_t k = 0; k < info.n_var; ++k)
             smooth_value[k] = pack_vec[info.offset + k];
-         const smooth_info& s_info = s_info_vec_[smooth_id];
          //
          // temp_1 = covariate multiplier fixed effects
-         temp_1 = grid2line(
+         smooth2line(
+            smooth_id,
             line_age,
             line_time,
-            age_table_,
-            time_table_,
-            s_info,
-            smooth_value
+            smooth_value,
+            temp_1,
+            work
          );
          for(size_t k = 0; k < n_line; ++k)
             effect[k] += temp_1[k] * x_j;
@@ -808,16 +925,15 @@ CppAD::vector<Float> adj_integrand::line(
          smooth_value.resize(info.n_var);
          for(size_t ell = 0; ell < info.n_var; ++ell)
             smooth_value[ell] = pack_vec[info.offset + ell];
-         const smooth_info& s_info = s_info_vec_[smooth_id];
          //
          // temp_1 = covariate multiplier random effects
-         temp_1 = grid2line(
+         smooth2line(
+            smooth_id,
             line_age,
             line_time,
-            age_table_,
-            time_table_,
-            s_info,
-            smooth_value
+            smooth_value,
+            temp_1,
+            work
          );
          for(size_t ell = 0; ell < n_line; ++ell)
             effect[ell] += temp_1[ell] * x_j;
@@ -844,8 +960,9 @@ CppAD::vector<Float> adj_integrand::line(
       const CppAD::vector<double>&                  x                ,    \
       const CppAD::vector<Float>&                   pack_vec         ,    \
       CppAD::vector<Float>&                         mulcov           ,    \
-      CppAD::vector< CppAD::vector<Float> >&        rate                  \
-   );                                                                     \
+      CppAD::vector< CppAD::vector<Float> >&        rate             ,    \
+      work_struct&                                  work                  \
+   ) const;                                                               \
 \
    CppAD::vector<Float> adj_integrand::line(                              \
       size_t                                        node_id          ,    \
@@ -856,7 +973,8 @@ CppAD::vector<Float> adj_integrand::line(
       size_t                                        child            ,    \
       size_t                                        subgroup_id      ,    \
       const CppAD::vector<double>&                  x                ,    \
-      const CppAD::vector<Float>&                   pack_vec         )    \
+      const CppAD::vector<Float>&                   pack_vec         ,    \
+      work_struct&                                  work             ) const \
    {  return line(                                                        \
          node_id,                                                        \
          line_age,                                                       \
@@ -867,8 +985,9 @@ CppAD::vector<Float> adj_integrand::line(
          subgroup_id,                                                    \
          x,                                                              \
          pack_vec,                                                       \
-         Float ## _mulcov_,                                              \
-         Float ## _rate_                                                 \
+         work.Float ## _mulcov,                                          \
+         work.Float ## _rate,                                            \
+         work                                                            \
       );                                                                 \
    }
 
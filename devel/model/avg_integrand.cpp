@@ -2,6 +2,11 @@
 // SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
 // SPDX-FileContributor: 2014-23 Bradley M. Bell
 // ----------------------------------------------------------------------------
+# include <vector>
+# include <set>
+# include <queue>
+# include <iterator>
+# include <functional>
 # include <cppad/mixed/exception.hpp>
 # include <dismod_at/avg_integrand.hpp>
 # include <dismod_at/grid2line.hpp>
@@ -9,6 +14,164 @@
 
 namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
 
+namespace { // BEGIN_EMPTY_NAMESPACE
+   //
+   // time_gap
+   // difference between two adjacent times in the time line for age_index
+   struct time_gap {
+      double diff;
+      size_t age_index;
+      double left;
+      double right;
+   };
+   //
+   // time_gap_less
+   // The top of a priority_queue using this order is the same difference
+   // as chosen by time_line_vec::max_time_diff; i.e., largest diff,
+   // then smallest age_index, then smallest time.
+   struct time_gap_less {
+      bool operator()(const time_gap& a, const time_gap& b) const
+      {  if( a.diff != b.diff )
+            return a.diff < b.diff;
+         if( a.age_index != b.age_index )
+            return a.age_index > b.age_index;
+         return a.left > b.left;
+      }
+   };
+   //
+   // maximum number of cohorts in the cache for one work space
+   const size_t max_cohort_cache_ = 10000;
+   //
+   // cohort_cache_check
+   // Return true if the cohort cache is on for this work space.
+   // Clear the cache if the pack_vec version has changed since it was filled.
+   bool cohort_cache_check(
+      avg_integrand::work_struct&     work     ,
+      const CppAD::vector<double>&    pack_vec )
+   {  if( work.pack_version == 0 )
+         return false;
+      if( work.cache_version != work.pack_version )
+      {  work.cohort_cache.clear();
+         work.cache_version = work.pack_version;
+      }
+      return true;
+   }
+   bool cohort_cache_check(
+      avg_integrand::work_struct&     work     ,
+      const CppAD::vector<a1_double>& pack_vec )
+   {  // a1_double values are not cached
+      return false;
+   }
+   //
+   // hash_combine
+   // combine the hash code seed with the hash code for value
+   template <class Value>
+   void hash_combine(size_t& seed, const Value& value)
+   {  seed ^= std::hash<Value>()(value)
+         + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+   }
+   //
+   // cohort_cache_get
+   // If the cohort with this hash_code and these inputs is in the cache,
+   // set line_adj to its values at the ages work.line_age.
+   // The ODE is solved forward in age, so a cached cohort that has more ages
+   // can be used when its first ages are the same as work.line_age.
+   bool cohort_cache_get(
+      avg_integrand::work_struct&     work         ,
+      size_t                          hash_code    ,
+      size_t                          node_id      ,
+      size_t                          n_child      ,
+      size_t                          child        ,
+      size_t                          subgroup_id  ,
+      size_t                          integrand_id ,
+      double                          time_ini     ,
+      const CppAD::vector<double>&    x            ,
+      CppAD::vector<double>&          line_adj     )
+   {  auto itr = work.cohort_cache.find(hash_code);
+      if( itr == work.cohort_cache.end() )
+         return false;
+      const avg_integrand::cohort_struct& cohort = itr->second;
+      size_t n_line = work.line_age.size();
+      bool match = cohort.node_id == node_id;
+      match     &= cohort.n_child == n_child;
+      match     &= cohort.child == child;
+      match     &= cohort.subgroup_id == subgroup_id;
+      match     &= cohort.integrand_id == integrand_id;
+      match     &= cohort.time_ini == time_ini;
+      match     &= cohort.x.size() == x.size();
+      match     &= n_line <= cohort.line_age.size();
+      for(size_t j = 0; match && j < x.size(); ++j)
+         match = cohort.x[j] == x[j];
+      for(size_t k = 0; match && k < n_line; ++k)
+         match = cohort.line_age[k] == work.line_age[k];
+      if( ! match )
+         return false;
+      line_adj.resize(n_line);
+      for(size_t k = 0; k < n_line; ++k)
+         line_adj[k] = cohort.line_adj[k];
+      return true;
+   }
+   bool cohort_cache_get(
+      avg_integrand::work_struct&     work         ,
+      size_t                          hash_code    ,
+      size_t                          node_id      ,
+      size_t                          n_child      ,
+      size_t                          child        ,
+      size_t                          subgroup_id  ,
+      size_t                          integrand_id ,
+      double                          time_ini     ,
+      const CppAD::vector<double>&    x            ,
+      CppAD::vector<a1_double>&       line_adj     )
+   {  return false; }
+   //
+   // cohort_cache_put
+   // Store the cohort with ages work.line_age and values line_adj in the
+   // cache using hash_code. This replaces the previous cohort with the same
+   // hash_code. If the cache is full, a new hash_code is not added.
+   void cohort_cache_put(
+      avg_integrand::work_struct&     work         ,
+      size_t                          hash_code    ,
+      size_t                          node_id      ,
+      size_t                          n_child      ,
+      size_t                          child        ,
+      size_t                          subgroup_id  ,
+      size_t                          integrand_id ,
+      double                          time_ini     ,
+      const CppAD::vector<double>&    x            ,
+      const CppAD::vector<double>&    line_adj     )
+   {  if( work.cohort_cache.size() >= max_cohort_cache_ )
+      {  if( work.cohort_cache.find(hash_code) == work.cohort_cache.end() )
+            return;
+      }
+      avg_integrand::cohort_struct& cohort = work.cohort_cache[hash_code];
+      cohort.node_id      = node_id;
+      cohort.n_child      = n_child;
+      cohort.child        = child;
+      cohort.subgroup_id  = subgroup_id;
+      cohort.integrand_id = integrand_id;
+      cohort.time_ini     = time_ini;
+      cohort.x.resize( x.size() );
+      cohort.x            = x;
+      cohort.line_age.resize( work.line_age.size() );
+      cohort.line_age     = work.line_age;
+      cohort.line_adj.resize( line_adj.size() );
+      cohort.line_adj     = line_adj;
+   }
+   void cohort_cache_put(
+      avg_integrand::work_struct&     work         ,
+      size_t                          hash_code    ,
+      size_t                          node_id      ,
+      size_t                          n_child      ,
+      size_t                          child        ,
+      size_t                          subgroup_id  ,
+      size_t                          integrand_id ,
+      double                          time_ini     ,
+      const CppAD::vector<double>&    x            ,
+      const CppAD::vector<a1_double>& line_adj     )
+   {  // a1_double values are not cached
+   }
+} // END_EMPTY_NAMESPACE
+
 /*
 ------------------------------------------------------------------------------
 {xrst_begin avg_integrand_ctor dev}
@@ -23,7 +186,7 @@ Syntax
 | |tab| *cov2weight_obj* ,
 | |tab| *ode_step_size* ,
 | |tab| *rate_case* ,
-| |tab| *age_avg_grid* ,
+| |tab| *ode_tolerance* ,
 | |tab| *age_table* ,
 | |tab| *time_table* ,
 | |tab| *covariate_table* ,
@@ -55,12 +218,11 @@ rate_case
 This is the value of
 :ref:`option_table@rate_case` in the option table.
 
-age_avg_grid
-************
-This is the :ref:`age_avg_grid-name` .
-A reference to *age_avg_grid* is used by *avgint_obj*
-( *age_avg_grid* must no be deleted for as long as
-*avgint_obj* is used).
+ode_tolerance
+*************
+This is the value of
+:ref:`option_table@ode_tolerance` in the option table
+(zero if it is empty).
 
 age_table
 *********
@@ -128,7 +290,7 @@ avg_integrand::avg_integrand(
       const cov2weight_map&                     cov2weight_obj   ,
       double                                    ode_step_size    ,
       const std::string&                        rate_case        ,
-      const CppAD::vector<double>&              age_avg_grid     ,
+      double                                    ode_tolerance    ,
       const CppAD::vector<double>&              age_table        ,
       const CppAD::vector<double>&              time_table       ,
       const CppAD::vector<covariate_struct>&    covariate_table  ,
@@ -146,12 +308,11 @@ time_table_                ( time_table )      ,
 subgroup_table_            ( subgroup_table )  ,
 integrand_table_           ( integrand_table ) ,
 w_info_vec_                ( w_info_vec )      ,
-double_time_line_object_   ( age_avg_grid )    ,
-a1_double_time_line_object_( age_avg_grid )    ,
 adjint_obj_(
    cov2weight_obj,
    w_info_vec,
    rate_case,
+   ode_tolerance,
    age_table,
    time_table,
    covariate_table,
@@ -162,6 +323,14 @@ adjint_obj_(
    pack_object
 )
 { }
+// work_struct
+avg_integrand::work_struct::work_struct(
+   const CppAD::vector<double>& age_avg_grid )
+:
+time_line_object          ( age_avg_grid ) ,
+pack_version              ( 0 )            ,
+cache_version             ( 0 )
+{ }
 /*
 ------------------------------------------------------------------------------
 {xrst_begin avg_integrand_rectangle dev}
@@ -172,6 +341,7 @@ Computing One Average Integrand
 Syntax
 ******
 
+| ``avg_integrand::work_struct`` *work* ( *age_avg_grid* )
 | *avg* = *avgint_obj* . ``rectangle`` (
 | |tab| *node_id*,
 | |tab| *age_lower* ,
@@ -184,16 +354,26 @@ Syntax
 | |tab| *child* ,
 | |tab| *subgroup_id* ,
 | |tab| *x* ,
-| |tab| *pack_vec*
+| |tab| *pack_vec* ,
+| |tab| *work*
 | )
 
 Prototype
 *********
 {xrst_literal
+   include/dismod_at/avg_integrand.hpp
    // BEGIN_RECTANGLE_PROTOTYPE
    // END_RECTANGLE_PROTOTYPE
 }
 
+Plan
+****
+This routine uses :ref:`avg_integrand_make_plan-name` to compute
+the plan for this rectangle in *work* and then uses
+:ref:`avg_integrand_plan_avg-name` to compute the average.
+If the same rectangle, weighting and integrand are used many times,
+it is faster to compute the plan once and call ``plan_avg`` directly.
+
 node_id
 *******
 is the node for this average integrand.
@@ -251,6 +431,26 @@ pack_vec
 is all the :ref:`model_variables-name` in the order
 specified by *pack_object* .
 
+work
+****
+This is work space used by ``rectangle`` to avoid re-allocating memory
+between calls. Its input value does not matter and its output value
+is unspecified.
+
+age_avg_grid
+============
+This is the :ref:`age_avg_grid-name` used to construct *work* .
+It is copied by the *work* constructor.
+
+Threads
+=======
+The *avgint_obj* is not changed by ``rectangle`` .
+Hence it can be used by multiple threads at the same time
+provided that each thread uses its own *work* .
+The memory in *work* should only be allocated by the thread that uses it;
+e.g., each thread can use a copy of a *work* object
+that has not been used yet.
+
 avg
 ***
 The return value *avg* is the average of the integrand
@@ -266,27 +466,77 @@ of using this routine.
 
 {xrst_end avg_integrand_rectangle}
 */
+/*
+-----------------------------------------------------------------------------
+{xrst_begin avg_integrand_make_plan dev}
 
-// BEGIN_RECTANGLE_PROTOTYPE
-template <class Float>
-Float avg_integrand::rectangle(
-   size_t                           node_id          ,
+Plan For Computing One Average Integrand
+########################################
+
+Syntax
+******
+
+| ``avg_integrand::plan_struct`` *plan*
+| *avgint_obj* . ``make_plan`` (
+| |tab| *age_lower* ,
+| |tab| *age_upper* ,
+| |tab| *time_lower* ,
+| |tab| *time_upper* ,
+| |tab| *weight_id* ,
+| |tab| *integrand_id* ,
+| |tab| *plan* ,
+| |tab| *work*
+| )
+
+Prototype
+*********
+{xrst_literal
+   include/dismod_at/avg_integrand.hpp
+   // BEGIN_MAKE_PLAN_PROTOTYPE
+   // END_MAKE_PLAN_PROTOTYPE
+}
+
+Purpose
+*******
+The lines (cohorts when the ODE is needed) in a rectangle,
+the weighting on these lines, and the coefficients for the
+:ref:`numeric_average-name` only depend on the rectangle,
+the weighting, and the integrand; i.e., they
+do not depend on the model variables.
+This routine computes this information once so it can be used by
+:ref:`avg_integrand_plan_avg-name` for many different
+values of the model variables.
+
+age_lower, age_upper, time_lower, time_upper, weight_id, integrand_id
+*********************************************************************
+These arguments have the same meaning as in
+:ref:`avg_integrand_rectangle-name` .
+
+plan
+****
+The input value of this argument does not matter.
+Upon return it contains the information for computing this average.
+The vectors in *plan* are re-sized and over written.
+
+work
+****
+is the :ref:`avg_integrand_rectangle@work` space used for
+computing *plan* .
+
+{xrst_end avg_integrand_make_plan}
+*/
+void avg_integrand::make_plan(
    double                           age_lower        ,
    double                           age_upper        ,
    double                           time_lower       ,
    double                           time_upper       ,
    size_t                           weight_id        ,
    size_t                           integrand_id     ,
-   size_t                           n_child          ,
-   size_t                           child            ,
-   size_t                           subgroup_id      ,
-   const CppAD::vector<double>&     x                ,
-   const CppAD::vector<Float>&      pack_vec         ,
-// END_RECTANGLE_PROTOTYPE
-   time_line_vec<Float>&            time_line_object ,
-   CppAD::vector<Float>&            line_adj         )
+   plan_struct&                     plan             ,
+   work_struct&                     work             ) const
 {  using CppAD::vector;
-   typedef typename time_line_vec<Float>::time_point  time_point;
+   typedef time_line_vec<double>::time_point  time_point;
+   time_line_vec<double>& time_line_object( work.time_line_object );
 
    // numerical precision
    double eps99 = 99.0 * std::numeric_limits<double>::epsilon();
@@ -304,11 +554,11 @@ Float avg_integrand::rectangle(
    size_t n_age  = w_info.age_size();
    size_t n_time = w_info.time_size();
 
-   // weight_grid_
-   weight_grid_.resize(n_age * n_time);
+   // work.weight_grid
+   work.weight_grid.resize(n_age * n_time);
    for(size_t i = 0; i < n_age; i++)
    {  for(size_t j = 0; j < n_time; ++j)
-         weight_grid_[i * n_time + j] = w_info.weight(i, j);
+         work.weight_grid[i * n_time + j] = w_info.weight(i, j);
    }
 
 
@@ -345,6 +595,17 @@ Float avg_integrand::rectangle(
       assert( false );
    }
 
+   // initialize plan
+   plan.integrand_id = integrand_id;
+   plan.need_ode     = need_ode;
+   plan.line_age.resize(0);
+   plan.line_time.resize(0);
+   plan.extend_grid.resize(0);
+   plan.cohort_time_ini.resize(0);
+   plan.cohort_n_line.resize(0);
+   plan.cohort_first.resize(0);
+   plan.coefficient.resize(0);
+
    // specialize the time_line object for this rectangle
    time_line_object.specialize(
       age_lower, age_upper, time_lower, time_upper
@@ -357,10 +618,10 @@ Float avg_integrand::rectangle(
    double                age_ini     = extend_grid[0];
 
    // age_lower == extend_grid[sub_lower]
-   assert(time_line_vec<Float>::near_equal(extend_grid[sub_lower],age_lower));
+   assert(time_line_vec<double>::near_equal(extend_grid[sub_lower],age_lower));
 
    // age_upper == extend_grid[sub_upper]
-   assert(time_line_vec<Float>::near_equal(extend_grid[sub_upper],age_upper));
+   assert(time_line_vec<double>::near_equal(extend_grid[sub_upper],age_upper));
 
    // n_age: number of ages (time line for each time line)
    n_age = sub_upper - sub_lower + 1;
@@ -383,223 +644,230 @@ Float avg_integrand::rectangle(
       }
       // n_line: total number of age, time points
       size_t n_line = n_age * n_time;
-      // resize temporaris
-      line_age_.resize(n_line);
-      line_time_.resize(n_line);
       //
-      // line_age_
-      // line_time_
+      // plan.line_age
+      // plan.line_time
+      plan.line_age.resize(n_line);
+      plan.line_time.resize(n_line);
       for(size_t i = 0; i < n_age; ++i)
       {  for(size_t j = 0; j < n_time; ++j)
          {  size_t k =  i * n_time + j;
             size_t age_index = sub_lower + i;
-            line_age_[k]     = extend_grid[age_index];
-            line_time_[k]    = time_lower + double(j) * d_time;
+            plan.line_age[k]     = extend_grid[age_index];
+            plan.line_time[k]    = time_lower + double(j) * d_time;
          }
       }
-      // line_adj
-      line_adj.resize(n_line);
-      line_adj = adjint_obj_.line(
-         node_id,
-         line_age_,
-         line_time_,
-         integrand_id,
-         n_child,
-         child,
-         subgroup_id,
-         x,
-         pack_vec
-      );
-      // line_weight_
-      line_weight_.resize(n_line);
-      line_weight_ = grid2line(
-         line_age_,
-         line_time_,
+      // work.line_weight
+      work.line_weight.resize(n_line);
+      work.line_weight = grid2line(
+         plan.line_age,
+         plan.line_time,
          age_table_,
          time_table_,
          w_info,
-         weight_grid_
+         work.weight_grid
       );
+      // The value for each point is its index in the line
       for(size_t i = 0; i < n_age; ++i)
       {  for(size_t j = 0; j < n_time; ++j)
          {  time_point point;
             size_t k         = i * n_time + j;
             size_t age_index = sub_lower + i;
-            point.time       = line_time_[k];
-            point.weight     = line_weight_[k];
-            point.value      = line_adj[k];
+            point.time       = plan.line_time[k];
+            point.weight     = work.line_weight[k];
+            point.value      = double(k);
             time_line_object.add_point(age_index, point);
          }
       }
-      Float avg = time_line_object.age_time_avg();
-      return avg;
+      plan.coefficient.resize(n_line);
    }
-   // -----------------------------------------------------------------------
-   assert( need_ode );
-   // -----------------------------------------------------------------------
-   // cohorts that go through extended age grid and rectangle at time_lower
-   // -----------------------------------------------------------------------
-   for(size_t age_index = sub_lower; age_index <= sub_upper; ++age_index)
-   {  // initial time for this cohort
-      double time_ini = time_lower - extend_grid[age_index] + age_ini;
+   else
+   {  // plan.extend_grid
+      plan.extend_grid.resize( extend_grid.size() );
+      plan.extend_grid = extend_grid;
       //
-      // add_cohort
-      add_cohort(
-         node_id,
-         time_ini,
-         time_lower,
-         time_upper,
-         weight_id,
-         integrand_id,
-         n_child,
-         child,
-         subgroup_id,
-         x,
-         pack_vec,
-         time_line_object,
-         line_adj
-      );
-   }
-   // -----------------------------------------------------------------------
-   if( one_time )
-   {  Float avg = time_line_object.age_time_avg();
-      return avg;
-   }
-   // -----------------------------------------------------------------------
-   // cohorts that go through extended age grid and rectangle at time_upper
-   // -----------------------------------------------------------------------
-   for(size_t age_index = sub_lower; age_index <= sub_upper; ++age_index)
-   {  // current time_line for this age index
-      const vector<time_point>& time_line =
-         time_line_object.time_line(age_index);
-
-      // maximum time currently in this time line
-      assert( time_line.size() > 0 );
-      double time_max = time_line[ time_line.size() - 1 ].time;
-
-      // check if this cohort has already been added
-      if( ! time_line_vec<Float>::near_equal(time_max, time_upper) )
-      {
-         // initial time for this cohort
-         double time_ini = time_upper - extend_grid[age_index] + age_ini;
+      // memory for the points in each time line: at most one for each
+      // cohort that starts at time_lower, one for time_upper, and about
+      // two for each ode_step_size_ of the time interval
+      size_t n_reserve = n_age + 1;
+      if( ! one_time )
+         n_reserve += 2 * size_t( (time_upper - time_lower) / ode_step_size_ );
+      time_line_object.reserve(n_reserve);
+      // --------------------------------------------------------------------
+      // cohorts that go through extended age grid and rectangle at time_lower
+      // --------------------------------------------------------------------
+      for(size_t age_index = sub_lower; age_index <= sub_upper; ++age_index)
+      {  // initial time for this cohort
+         double time_ini = time_lower - extend_grid[age_index] + age_ini;
          //
-         // add_cohort
-         add_cohort(
-            node_id,
-            time_ini,
-            time_lower,
-            time_upper,
-            weight_id,
-            integrand_id,
-            n_child,
-            child,
-            subgroup_id,
-            x,
-            pack_vec,
-            time_line_object,
-            line_adj
-         );
+         // plan_cohort
+         plan_cohort(time_ini, time_lower, time_upper, w_info, plan, work);
       }
-   }
+      time_line_object.merge();
+      // --------------------------------------------------------------------
+      // cohorts that go through extended age grid and rectangle at time_upper
+      // --------------------------------------------------------------------
+      // The cohort for age_index only adds points to time lines with
+      // smaller age index, so the time line for age_index is still sorted.
+      if( ! one_time )
+      for(size_t age_index = sub_lower; age_index <= sub_upper; ++age_index)
+      {  // current time_line for this age index
+         const vector<time_point>& time_line =
+            time_line_object.time_line(age_index);
+
+         // maximum time currently in this time line
+         assert( time_line.size() > 0 );
+         double time_max = time_line[ time_line.size() - 1 ].time;
+
+         // check if this cohort has already been added
+         if( ! time_line_vec<double>::near_equal(time_max, time_upper) )
+         {
+            // initial time for this cohort
+            double time_ini = time_upper - extend_grid[age_index] + age_ini;
+            //
+            // plan_cohort
+            plan_cohort(time_ini, time_lower, time_upper, w_info, plan, work);
+         }
+      }
+      time_line_object.merge();
 # ifndef NDEBUG
-   for(size_t age_index = sub_lower; age_index <= sub_upper; ++age_index)
-   {  const vector<time_point>& time_line =
-         time_line_object.time_line(age_index);
-      assert( time_line.size() > 0 );
-      //
-      double time = time_line[0].time;
-      assert( time_line_vec<Float>::near_equal(time_lower, time) );
-      //
-      time = time_line[ time_line.size() - 1 ].time;
-      assert( time_line_vec<Float>::near_equal(time_upper, time) );
-   }
+      if( ! one_time )
+      for(size_t age_index = sub_lower; age_index <= sub_upper; ++age_index)
+      {  const vector<time_point>& time_line =
+            time_line_object.time_line(age_index);
+         assert( time_line.size() > 0 );
+         //
+         double time = time_line[0].time;
+         assert( time_line_vec<double>::near_equal(time_lower, time) );
+         //
+         time = time_line[ time_line.size() - 1 ].time;
+         assert( time_line_vec<double>::near_equal(time_upper, time) );
+      }
 # endif
-   // -----------------------------------------------------------------------
-   // ensure that time_line_object.max_time_diff <= ode_step_size_
-   // -----------------------------------------------------------------------
-   size_t age_index, time_index;
-   double max_diff = time_line_object.max_time_diff(age_index, time_index);
-   while( max_diff > (1.0 + eps99) * ode_step_size_ )
-   {  assert( time_index > 0 );
-
-      // time_line with maximum time difference
-      const vector<time_point>& time_line =
-         time_line_object.time_line(age_index);
+      // --------------------------------------------------------------------
+      // ensure that time_line_object.max_time_diff <= ode_step_size_
+      // --------------------------------------------------------------------
+      // The cohort through the middle of the maximum time difference is
+      // added one at a time. The time differences are kept in a heap with
+      // the same order as max_time_diff uses to choose between them
+      // (largest difference, then smallest age index, then smallest time),
+      // so the cohorts are the same as calling max_time_diff after each one.
+      // Only the differences that a new cohort splits are updated.
+      // An entry in the heap is removed when it is on top and its
+      // interval has been split.
+      if( ! one_time )
+      {  // line_times[i]: times in the time line for sub_lower + i
+         std::vector< std::set<double> > line_times(n_age);
+         std::priority_queue<time_gap, std::vector<time_gap>, time_gap_less>
+            gap_heap;
+         for(size_t age_index = sub_lower; age_index <= sub_upper; ++age_index)
+         {  const vector<time_point>& time_line =
+               time_line_object.time_line(age_index);
+            std::set<double>& times = line_times[age_index - sub_lower];
+            times.insert( time_line[0].time );
+            for(size_t j = 1; j < time_line.size(); ++j)
+            {  times.insert( time_line[j].time );
+               time_gap gap;
+               gap.diff      = time_line[j].time - time_line[j-1].time;
+               gap.age_index = age_index;
+               gap.left      = time_line[j-1].time;
+               gap.right     = time_line[j].time;
+               gap_heap.push(gap);
+            }
+         }
+         while( ! gap_heap.empty() )
+         {  time_gap top = gap_heap.top();
+            gap_heap.pop();
+            //
+            // check if this interval has been split
+            size_t i = top.age_index - sub_lower;
+            if( *line_times[i].upper_bound(top.left) != top.right )
+               continue;
+            //
+            // check if this is small enough
+            if( top.diff <= (1.0 + eps99) * ode_step_size_ )
+               break;
+            //
+            // time at the middle of the maximum difference
+            double time_mid      = (top.left + top.right) / 2.0;
+
+            // initial time for cohort that goes through this time line at
+            // time_mid
+            double age           = extend_grid[top.age_index];
+            double time_ini      = time_mid - age + age_ini;
+
+            // plan_cohort
+            plan_cohort(time_ini, time_lower, time_upper, w_info, plan, work);
+            //
+            // split the intervals that contain the new points
+            size_t k_first = plan.cohort_first[ plan.cohort_first.size() - 1 ];
+            size_t k_end   = plan.cohort_n_line[plan.cohort_n_line.size() - 1];
+            for(size_t k = k_first; k < k_end; ++k)
+            {  double time = work.line_time[k];
+               std::set<double>& times = line_times[k - sub_lower];
+               auto itr = times.insert(time).first;
+               time_gap gap;
+               gap.age_index = k;
+               if( itr != times.begin() )
+               {  gap.left  = *std::prev(itr);
+                  gap.right = time;
+                  gap.diff  = gap.right - gap.left;
+                  gap_heap.push(gap);
+               }
+               if( std::next(itr) != times.end() )
+               {  gap.left  = time;
+                  gap.right = *std::next(itr);
+                  gap.diff  = gap.right - gap.left;
+                  gap_heap.push(gap);
+               }
+            }
+         }
+         time_line_object.merge();
 # ifndef NDEBUG
-      double check =
-         time_line[time_index].time - time_line[time_index-1].time;
-      assert( time_line_vec<Float>::near_equal(check, max_diff) );
+         size_t age_index, time_index;
+         double max_diff =
+            time_line_object.max_time_diff(age_index, time_index);
+         assert( max_diff <= (1.0 + eps99) * ode_step_size_ );
 # endif
-
-      // time at the middle of the maximum difference
-      n_time               = time_line.size();
-      double time_left     = time_line[time_index - 1].time;
-      double time_right    = time_line[time_index].time;
-      double time_mid      = (time_left + time_right) / 2.0;
-
-      // initial time for cohort that goes through this time line at time_mid
-      double age           = extend_grid[age_index];
-      double time_ini      = time_mid - age + age_ini;
-
-      // add_cohort
-      add_cohort(
-         node_id,
-         time_ini,
-         time_lower,
-         time_upper,
-         weight_id,
-         integrand_id,
-         n_child,
-         child,
-         subgroup_id,
-         x,
-         pack_vec,
-         time_line_object,
-         line_adj
-      );
-      //
-      // max_diff, age_index, time_index
-      max_diff = time_line_object.max_time_diff(age_index, time_index);
+      }
    }
    // -----------------------------------------------------------------------
-   Float avg = time_line_object.age_time_avg();
-   return avg;
+   // plan.coefficient
+   // The value for each point in the time lines is its index in
+   // plan.coefficient.
+   vector<double> coef = time_line_object.age_time_coef();
+   size_t m = 0;
+   for(size_t age_index = sub_lower; age_index <= sub_upper; ++age_index)
+   {  const vector<time_point>& time_line =
+         time_line_object.time_line(age_index);
+      for(size_t j = 0; j < time_line.size(); ++j)
+      {  size_t k = size_t( time_line[j].value );
+         assert( k < plan.coefficient.size() );
+         plan.coefficient[k] = coef[m++];
+      }
+   }
+   assert( m == plan.coefficient.size() );
+   return;
 }
 /*
 -----------------------------------------------------------------------------
-{xrst_begin avg_integrand_add_cohort dev}
-{xrst_spell
-   adj
-}
+{xrst_begin avg_integrand_plan_cohort dev}
 
-Add ODE Solution for One Cohort To time_line_object
-###################################################
+Add One Cohort To a Plan
+########################
 
 Syntax
 ******
 
-| *avg* = *avgint_obj* . ``add_cohort`` (
-| |tab| *node_id* ,
-| |tab| *time_ini* ,
-| |tab| *time_lower* ,
-| |tab| *time_upper* ,
-| |tab| *weight_id* ,
-| |tab| *integrand_id* ,
-| |tab| *n_child* ,
-| |tab| *child* ,
-| |tab| *subgroup_id* ,
-| |tab| *x* ,
-| |tab| *pack_vec* ,
-| |tab| *extend_grid* ,
-| |tab| *time_line_object* ,
-| |tab| *line_adj*
+| *avgint_obj* . ``plan_cohort`` (
+| |tab| *time_ini* , *time_lower* , *time_upper* , *w_info* , *plan* , *work*
 | )
 
 Prototype
 *********
 {xrst_literal
-   // BEGIN_ADD_COHORT_PROTOTYPE
-   // END_ADD_COHORT_PROTOTYPE
+   // BEGIN_PLAN_COHORT_PROTOTYPE
+   // END_PLAN_COHORT_PROTOTYPE
 }
 
 time_ini
@@ -610,108 +878,58 @@ corresponding to :ref:`rate_table@rate_name@pini` .
 time_lower
 **********
 lower time for the rectangle restricting which points are added
-to *time_line_object* .
+to the time lines.
 
 time_upper
 **********
 upper time for the rectangle restricting which points are added
-to *time_line_object* .
-
-weight_id
-*********
-This is the :ref:`weight_table@weight_id`
-in the weight table corresponding to this average integrand.
-
-integrand_id
-************
-This is the :ref:`integrand_table@integrand_id`
-in the integrand table corresponding to this average integrand.
-
-n_child\_
-*********
-set to number of :ref:`option_table@Parent Node@Children` .
+to the time lines.
 
-child
-*****
-Is the :ref:`child_info@table_id2child@child` corresponding
-to this average.
-
-subgroup_id
-***********
-Is the :ref:`avgint_table@subgroup_id` for this average integrand.
-
-x
-*
-This is the vector of covariates for this average.
-
-Float
-=====
-The type *Float* must be ``double`` or
-:ref:`a1_double-name` .
-
-pack_vec
-********
-is all the :ref:`model_variables-name` in the order
-specified by *pack_object* .
-
-time_line_object
-****************
-This is the object that are adding the cohort to.
+w_info
+******
+is the weighting for this average.
+
+plan
+****
+The cohort is added to the end of the cohort vectors in *plan* .
+An element is added to *plan* . ``coefficient`` for each point in the
+cohort that is also in the rectangle.
+
+work
+****
+The vector *work* . ``weight_grid`` is the weighting on *w_info* grid.
+Each cohort point in the rectangle is added to
+*work* . ``time_line_object`` using its index in
+*plan* . ``coefficient`` as its value.
+The points are added using
+:ref:`time_line_vec@append_point` ,
+so the caller must use :ref:`time_line_vec@merge`
+before accessing the time lines.
 Only cohort points that have time between *time_lower*
 and *time_upper* (to numerical precision) are added.
 In addition, only cohort points that have age index between
 :ref:`time_line_vec@sub_lower` and
 :ref:`time_line_vec@sub_upper`
 (inclusive) are added.
+The vectors *work* . ``line_age`` , *work* . ``line_time`` ,
+and *work* . ``line_weight`` are re-sized and over written.
 
-line_adj
-********
-is a temporary vector that is re-sized and over written
-(but not re-allocated).
-
-Member Variables
-****************
-
-line_age\_
-==========
-is a temporary vector that is re-sized and over written
-(but not re-allocated).
-
-line_time\_
-===========
-is a temporary vector that is re-sized and over written
-(but not re-allocated).
-
-{xrst_end avg_integrand_add_cohort}
+{xrst_end avg_integrand_plan_cohort}
 */
-// BEGIN_ADD_COHORT_PROTOTYPE
-template <class Float>
-void avg_integrand::add_cohort(
-   size_t                       node_id                          ,
+// BEGIN_PLAN_COHORT_PROTOTYPE
+void avg_integrand::plan_cohort(
    double                       time_ini                         ,
    double                       time_lower                       ,
    double                       time_upper                       ,
-   size_t                       weight_id                        ,
-   size_t                       integrand_id                     ,
-   size_t                       n_child                          ,
-   size_t                       child                            ,
-   size_t                       subgroup_id                      ,
-   const CppAD::vector<double>& x                                ,
-   const CppAD::vector<Float>&  pack_vec                         ,
-   time_line_vec<Float>&        time_line_object                 ,
-   CppAD::vector<Float>&        line_adj                         )
-// END_ADD_COHORT_PROTOTYPE
+   const weight_info&           w_info                           ,
+   plan_struct&                 plan                             ,
+   work_struct&                 work                             ) const
+// END_PLAN_COHORT_PROTOTYPE
 {  // numerical percision
    double eps99 = 99.0 * std::numeric_limits<double>::epsilon();
 
-   // weight information for this average
-   // constant weighting is at the end of w_info_vec_
-   size_t weight_index = w_info_vec_.size() - 1;
-   if( weight_id != DISMOD_AT_NULL_SIZE_T )
-   {  assert( weight_id < weight_index );
-      weight_index = weight_id;
-   }
-   const weight_info& w_info( w_info_vec_[weight_index] );
+   // time_line_object
+   time_line_vec<double>& time_line_object( work.time_line_object );
 
    // extend_grid
    const CppAD::vector<double>& extend_grid = time_line_object.extend_grid();
@@ -744,81 +962,300 @@ void avg_integrand::add_cohort(
    // n_line
    size_t n_line = age_index + 1;
 
-   // line_age_, line_time_
-   line_age_.resize(n_line);
-   line_time_.resize(n_line);
+   // work.line_age, work.line_time
+   work.line_age.resize(n_line);
+   work.line_time.resize(n_line);
    for(size_t k = 0; k < n_line; ++k)
-   {  line_age_[k]  = extend_grid[k];
-      line_time_[k] = time_ini + line_age_[k] - age_ini;
+   {  work.line_age[k]  = extend_grid[k];
+      work.line_time[k] = time_ini + work.line_age[k] - age_ini;
    }
 
-   // line_adj
-   line_adj.resize(n_line);
-   line_adj = adjint_obj_.line(
-      node_id,
-      line_age_,
-      line_time_,
-      integrand_id,
-      n_child,
-      child,
-      subgroup_id,
-      x,
-      pack_vec
-   );
-
-   // line_weight_
-   line_weight_.resize(n_line);
-   line_weight_ = grid2line(
-      line_age_,
-      line_time_,
+   // work.line_weight
+   work.line_weight.resize(n_line);
+   work.line_weight = grid2line(
+      work.line_age,
+      work.line_time,
       age_table_,
       time_table_,
       w_info,
-      weight_grid_
+      work.weight_grid
    );
 
    // age_index for first point in cohort with
    // time_lower <= time and age_lower <= age
    age_index = sub_lower;
-   next_age  = line_time_[age_index] < (1.0 - eps99) * time_lower;
+   next_age  = work.line_time[age_index] < (1.0 - eps99) * time_lower;
    while( next_age )
    {  // cohort must intersect rectangle
       assert( age_index < sub_upper );
       //
       ++age_index;
-      next_age  = line_time_[age_index] < (1.0 - eps99) * time_lower;
+      next_age  = work.line_time[age_index] < (1.0 - eps99) * time_lower;
    }
 
-   // time_line_object.add_point
+   // plan
+   plan.cohort_time_ini.push_back( time_ini );
+   plan.cohort_n_line.push_back( n_line );
+   plan.cohort_first.push_back( age_index );
+
+   // time_line_object.append_point
    for(size_t k = age_index; k < n_line; ++k)
-   {  typename time_line_vec<Float>::time_point point;
-      point.time       = line_time_[k];
-      point.weight     = line_weight_[k];
-      point.value      = line_adj[k];
-      time_line_object.add_point(k, point);
+   {  time_line_vec<double>::time_point point;
+      point.time       = work.line_time[k];
+      point.weight     = work.line_weight[k];
+      point.value      = double( plan.coefficient.size() );
+      time_line_object.append_point(k, point);
+      plan.coefficient.push_back( 0.0 );
    }
 
    return;
 }
+/*
+-----------------------------------------------------------------------------
+{xrst_begin avg_integrand_plan_avg dev}
+{xrst_spell
+   adj
+}
+
+Computing One Average Integrand Using a Plan
+############################################
+
+Syntax
+******
+
+| *avg* = *avgint_obj* . ``plan_avg`` (
+| |tab| *node_id* ,
+| |tab| *n_child* ,
+| |tab| *child* ,
+| |tab| *subgroup_id* ,
+| |tab| *x* ,
+| |tab| *pack_vec* ,
+| |tab| *plan* ,
+| |tab| *work*
+| )
+
+Prototype
+*********
+{xrst_literal
+   include/dismod_at/avg_integrand.hpp
+   // BEGIN_PLAN_AVG_PROTOTYPE
+   // END_PLAN_AVG_PROTOTYPE
+}
+
+node_id, n_child, child, subgroup_id, x, pack_vec
+*************************************************
+These arguments have the same meaning as in
+:ref:`avg_integrand_rectangle-name` .
+
+plan
+****
+This is the :ref:`avg_integrand_make_plan@plan`
+for the rectangle, weighting, and integrand for this average.
+The only work done by ``plan_avg`` ,
+that depends on *pack_vec* ,
+is computing the adjusted integrand on each line in the plan
+(which includes solving the ODE when it is needed)
+and multiplying by the coefficients in the plan.
+
+work
+****
+is the :ref:`avg_integrand_rectangle@work` space for this call.
+
+Cohort Cache
+============
+If *Float* is ``double`` and *work* . ``pack_version`` is not zero,
+the adjusted integrand for each cohort is stored in
+*work* . ``cohort_cache`` .
+A cohort is identified by
+*node_id* , *n_child* , *child* , *subgroup_id* , *integrand_id* ,
+*x* , and the initial time for the cohort.
+The cache is a hash table using a hash code for these values,
+so finding a cohort does not require comparing it with the other cohorts.
+The ODE is solved forward in age. Hence a cohort in the cache can be
+used for any average whose cohort ages are the first ages in the
+cached cohort; e.g., when the cached cohort went through a rectangle
+with a larger upper time.
+In this case the values in the cache are used instead of solving the ODE.
+This happens when many data points have the same node, covariates,
+and cohort initial times.
+A cohort that cannot be used from the cache replaces the cohort
+with the same hash code.
+The caller must set *work* . ``pack_version`` to a new non-zero value
+each time *pack_vec* changes (or zero to not use the cache);
+see :ref:`data_model_average@Cohort Cache` .
+The cache is cleared when *work* . ``pack_version``
+is different from its value when the cache was filled
+(this is order one, instead of comparing *pack_vec* element by element).
+When the cache contains its maximum number of cohorts,
+new hash codes are not added to it.
+Each thread has its own work space, hence its own cache.
+
+avg
+***
+The return value *avg* is the average of the integrand
+using the weighting and rectangle in *plan* .
+
+{xrst_end avg_integrand_plan_avg}
+*/
+template <class Float>
+Float avg_integrand::plan_avg(
+   size_t                           node_id          ,
+   size_t                           n_child          ,
+   size_t                           child            ,
+   size_t                           subgroup_id      ,
+   const CppAD::vector<double>&     x                ,
+   const CppAD::vector<Float>&      pack_vec         ,
+   const plan_struct&               plan             ,
+   CppAD::vector<Float>&            line_adj         ,
+   work_struct&                     work             ) const
+{  size_t integrand_id = plan.integrand_id;
+   Float  avg          = 0.0;
+   // -----------------------------------------------------------------------
+   if( ! plan.need_ode )
+   // -----------------------------------------------------------------------
+   {  size_t n_line = plan.line_age.size();
+      assert( plan.coefficient.size() == n_line );
+      //
+      // line_adj
+      line_adj.resize(n_line);
+      line_adj = adjint_obj_.line(
+         node_id,
+         plan.line_age,
+         plan.line_time,
+         integrand_id,
+         n_child,
+         child,
+         subgroup_id,
+         x,
+         pack_vec,
+         work.adjint_work
+      );
+      for(size_t k = 0; k < n_line; ++k)
+         avg += plan.coefficient[k] * line_adj[k];
+      return avg;
+   }
+   // -----------------------------------------------------------------------
+   // cohorts in the cache are only valid for this version of pack_vec
+   bool use_cache = cohort_cache_check(work, pack_vec);
+   //
+   // hash_avg
+   // hash code for the cache inputs that are the same for all the cohorts
+   size_t hash_avg = 0;
+   if( use_cache )
+   {  hash_combine(hash_avg, node_id);
+      hash_combine(hash_avg, n_child);
+      hash_combine(hash_avg, child);
+      hash_combine(hash_avg, subgroup_id);
+      hash_combine(hash_avg, integrand_id);
+      for(size_t j = 0; j < x.size(); ++j)
+         hash_combine(hash_avg, x[j]);
+   }
+   //
+   double age_ini  = plan.extend_grid[0];
+   size_t n_cohort = plan.cohort_time_ini.size();
+   size_t m        = 0;
+   for(size_t i = 0; i < n_cohort; ++i)
+   {  double time_ini = plan.cohort_time_ini[i];
+      size_t n_line   = plan.cohort_n_line[i];
+      //
+      // work.line_age, work.line_time
+      work.line_age.resize(n_line);
+      work.line_time.resize(n_line);
+      for(size_t k = 0; k < n_line; ++k)
+      {  work.line_age[k]  = plan.extend_grid[k];
+         work.line_time[k] = time_ini + work.line_age[k] - age_ini;
+      }
+      //
+      // hash_code
+      size_t hash_code = hash_avg;
+      if( use_cache )
+         hash_combine(hash_code, time_ini);
+      //
+      // line_adj
+      bool found = false;
+      if( use_cache ) found = cohort_cache_get(
+         work,
+         hash_code,
+         node_id,
+         n_child,
+         child,
+         subgroup_id,
+         integrand_id,
+         time_ini,
+         x,
+         line_adj
+      );
+      if( ! found )
+      {  line_adj.resize(n_line);
+         line_adj = adjint_obj_.line(
+            node_id,
+            work.line_age,
+            work.line_time,
+            integrand_id,
+            n_child,
+            child,
+            subgroup_id,
+            x,
+            pack_vec,
+            work.adjint_work
+         );
+         if( use_cache ) cohort_cache_put(
+            work,
+            hash_code,
+            node_id,
+            n_child,
+            child,
+            subgroup_id,
+            integrand_id,
+            time_ini,
+            x,
+            line_adj
+         );
+      }
+      //
+      // avg
+      for(size_t k = plan.cohort_first[i]; k < n_line; ++k)
+         avg += plan.coefficient[m++] * line_adj[k];
+   }
+   assert( m == plan.coefficient.size() );
+   return avg;
+}
 
 # define DISMOD_AT_INSTANTIATE_AVG_INTEGRAND_RECTANGLE(Float)  \
    template                                                   \
-   Float avg_integrand::rectangle(                            \
+   Float avg_integrand::plan_avg(                             \
       size_t                           node_id          ,    \
-      double                           age_lower        ,    \
-      double                           age_upper        ,    \
-      double                           time_lower       ,    \
-      double                           time_upper       ,    \
-      size_t                           weight_id        ,    \
-      size_t                           integrand_id     ,    \
       size_t                           n_child          ,    \
       size_t                           child            ,    \
       size_t                           subgroup_id      ,    \
       const CppAD::vector<double>&     x                ,    \
       const CppAD::vector<Float>&      pack_vec         ,    \
-      time_line_vec<Float>&            time_line_object ,    \
-      CppAD::vector<Float>&            line_adj              \
-   );                                                         \
+      const plan_struct&               plan             ,    \
+      CppAD::vector<Float>&            line_adj         ,    \
+      work_struct&                     work                  \
+   ) const;                                                   \
+\
+   Float avg_integrand::plan_avg(                            \
+      size_t                           node_id          ,    \
+      size_t                           n_child          ,    \
+      size_t                           child            ,    \
+      size_t                           subgroup_id      ,    \
+      const CppAD::vector<double>&     x                ,    \
+      const CppAD::vector<Float>&      pack_vec         ,    \
+      const plan_struct&               plan             ,    \
+      work_struct&                     work             ) const \
+   {  return plan_avg(                                       \
+         node_id,                                           \
+         n_child,                                           \
+         child,                                             \
+         subgroup_id,                                       \
+         x,                                                 \
+         pack_vec,                                          \
+         plan,                                              \
+         work.Float ## _line_adj,                           \
+         work                                               \
+      );                                                    \
+   }                                                        \
 \
    Float avg_integrand::rectangle(                           \
       size_t                           node_id          ,    \
@@ -832,41 +1269,30 @@ void avg_integrand::add_cohort(
       size_t                           child            ,    \
       size_t                           subgroup_id      ,    \
       const CppAD::vector<double>&     x                ,    \
-      const CppAD::vector<Float>&      pack_vec         )    \
-   {  return rectangle(                                      \
-         node_id,                                           \
+      const CppAD::vector<Float>&      pack_vec         ,    \
+      work_struct&                     work             ) const \
+   {  make_plan(                                             \
          age_lower,                                         \
          age_upper,                                         \
          time_lower,                                        \
          time_upper,                                        \
          weight_id,                                         \
          integrand_id,                                      \
+         work.plan,                                         \
+         work                                               \
+      );                                                    \
+      return plan_avg(                                      \
+         node_id,                                           \
          n_child,                                           \
          child,                                             \
          subgroup_id,                                       \
          x,                                                 \
          pack_vec,                                          \
-         Float ## _time_line_object_,                       \
-         Float ## _line_adj_                                \
+         work.plan,                                         \
+         work.Float ## _line_adj,                           \
+         work                                               \
       );                                                    \
-   }                                                        \
-\
-   template                                                  \
-   void avg_integrand::add_cohort(                           \
-      size_t                       node_id              ,    \
-      double                       time_ini             ,    \
-      double                       time_lower           ,    \
-      double                       time_upper           ,    \
-      size_t                       weight_id            ,    \
-      size_t                       integrand_id         ,    \
-      size_t                       n_child              ,    \
-      size_t                       child                ,    \
-      size_t                       subgroup_id          ,    \
-      const CppAD::vector<double>& x                    ,    \
-      const CppAD::vector<Float>&  pack_vec             ,    \
-      time_line_vec<Float>&        time_line_object     ,    \
-      CppAD::vector<Float>&        line_adj                  \
-      );
+   }
 
 // instantiations
 DISMOD_AT_INSTANTIATE_AVG_INTEGRAND_RECTANGLE( double )
@@ -21,7 +21,6 @@ Syntax
 
 | ``avg_noise_effect`` *avg_noise_obj* (
 | |tab| *ode_step_size* ,
-| |tab| *age_avg_grid* ,
 | |tab| *age_table* ,
 | |tab| *time_table* ,
 | |tab| *subgroup_table* ,
@@ -43,13 +42,6 @@ ode_step_size
 This is the value of
 :ref:`option_table@Age Average Grid@ode_step_size` in the option table.
 
-age_avg_grid
-************
-This is the :ref:`age_avg_grid-name` .
-A reference to *age_avg_grid* is used by *avg_noise_obj*
-( *age_avg_grid* must no be deleted for as long as
-*avg_noise_obj* is used).
-
 age_table
 *********
 This argument is the :ref:`age_table-name` .
@@ -107,7 +99,6 @@ of using this routine.
 // BEGIN_AVG_NOISE_EFFECT_PROTOTYPE
 avg_noise_effect::avg_noise_effect(
       double                                    ode_step_size    ,
-      const CppAD::vector<double>&              age_avg_grid     ,
       const CppAD::vector<double>&              age_table        ,
       const CppAD::vector<double>&              time_table       ,
       const CppAD::vector<subgroup_struct>&     subgroup_table   ,
@@ -124,9 +115,14 @@ subgroup_table_            ( subgroup_table )  ,
 integrand_table_           ( integrand_table ) ,
 w_info_vec_                ( w_info_vec )      ,
 s_info_vec_                ( s_info_vec )      ,
-pack_object_               ( pack_object )     ,
-double_time_line_object_   ( age_avg_grid )    ,
-a1_double_time_line_object_( age_avg_grid )
+pack_object_               ( pack_object )
+{ }
+// work_struct
+avg_noise_effect::work_struct::work_struct(
+   const CppAD::vector<double>& age_avg_grid )
+:
+double_time_line_object   ( age_avg_grid )    ,
+a1_double_time_line_object( age_avg_grid )
 { }
 /*
 ------------------------------------------------------------------------------
@@ -138,6 +134,7 @@ Computing One Average Integrand
 Syntax
 ******
 
+| ``avg_noise_effect::work_struct`` *work* ( *age_avg_grid* )
 | *avg* = *avg_noise_obj* . ``rectangle`` (
 | |tab| *age_lower* ,
 | |tab| *age_upper* ,
@@ -147,7 +144,8 @@ Syntax
 | |tab| *subgroup_id* ,
 | |tab| *integrand_id* ,
 | |tab| *x* ,
-| |tab| *pack_vec*
+| |tab| *pack_vec* ,
+| |tab| *work*
 | )
 
 Prototype
@@ -202,6 +200,17 @@ pack_vec
 is all the :ref:`model_variables-name` in the order
 specified by *pack_object* .
 
+work
+****
+This is work space used by ``rectangle`` to avoid re-allocating memory
+between calls; see
+:ref:`avg_integrand_rectangle@work` for the corresponding
+average integrand work space.
+
+age_avg_grid
+============
+This is the :ref:`age_avg_grid-name` used to construct *work* .
+
 avg
 ***
 The return value *avg* is the average of the integrand
@@ -232,7 +241,8 @@ Float avg_noise_effect::rectangle(
    const CppAD::vector<Float>&      pack_vec         ,
 // END_RECTANGLE_PROTOTYPE
    time_line_vec<Float>&            time_line_object ,
-   CppAD::vector<Float>&            effect           )
+   CppAD::vector<Float>&            effect           ,
+   work_struct&                     work             ) const
 {  using CppAD::vector;
    typedef typename time_line_vec<Float>::time_point  time_point;
 
@@ -252,11 +262,11 @@ Float avg_noise_effect::rectangle(
    size_t n_age  = w_info.age_size();
    size_t n_time = w_info.time_size();
 
-   // weight_grid_
-   weight_grid_.resize(n_age * n_time);
+   // work.weight_grid
+   work.weight_grid.resize(n_age * n_time);
    for(size_t i = 0; i < n_age; i++)
    {  for(size_t j = 0; j < n_time; ++j)
-         weight_grid_[i * n_time + j] = w_info.weight(i, j);
+         work.weight_grid[i * n_time + j] = w_info.weight(i, j);
    }
 
 
@@ -297,17 +307,17 @@ Float avg_noise_effect::rectangle(
    size_t n_line = n_age * n_time;
 
    // resize temporaris
-   line_age_.resize(n_line);
-   line_time_.resize(n_line);
+   work.line_age.resize(n_line);
+   work.line_time.resize(n_line);
 
-   // line_age_
-   // line_time_
+   // work.line_age
+   // work.line_time
    for(size_t i = 0; i < n_age; ++i)
    {  for(size_t j = 0; j < n_time; ++j)
       {  size_t k =  i * n_time + j;
          size_t age_index = sub_lower + i;
-         line_age_[k]     = extend_grid[age_index];
-         line_time_[k]    = time_lower + double(j) * d_time;
+         work.line_age[k]     = extend_grid[age_index];
+         work.line_time[k]    = time_lower + double(j) * d_time;
       }
    }
 
@@ -338,8 +348,8 @@ Float avg_noise_effect::rectangle(
             smooth_value[k] = pack_vec[info.offset + k];
          const smooth_info& s_info = s_info_vec_[smooth_id];
          temp = grid2line(
-            line_age_,
-            line_time_,
+            work.line_age,
+            work.line_time,
             age_table_,
             time_table_,
             s_info,
@@ -351,23 +361,23 @@ Float avg_noise_effect::rectangle(
       }
    }
    // -----------------------------------------------------------------------
-   // line_weight_
-   line_weight_.resize(n_line);
-   line_weight_ = grid2line(
-      line_age_,
-      line_time_,
+   // work.line_weight
+   work.line_weight.resize(n_line);
+   work.line_weight = grid2line(
+      work.line_age,
+      work.line_time,
       age_table_,
       time_table_,
       w_info,
-      weight_grid_
+      work.weight_grid
    );
    for(size_t i = 0; i < n_age; ++i)
    {  for(size_t j = 0; j < n_time; ++j)
       {  time_point point;
          size_t k         = i * n_time + j;
          size_t age_index = sub_lower + i;
-         point.time       = line_time_[k];
-         point.weight     = line_weight_[k];
+         point.time       = work.line_time[k];
+         point.weight     = work.line_weight[k];
          point.value      = effect[k];
          time_line_object.add_point(age_index, point);
       }
@@ -389,8 +399,9 @@ Float avg_noise_effect::rectangle(
       const CppAD::vector<double>&     x                ,    \
       const CppAD::vector<Float>&      pack_vec         ,    \
       time_line_vec<Float>&            time_line_object ,    \
-      CppAD::vector<Float>&            line_adj              \
-   );                                                         \
+      CppAD::vector<Float>&            effect           ,    \
+      work_struct&                     work                  \
+   ) const;                                                   \
 \
    Float avg_noise_effect::rectangle(                           \
       double                           age_lower        ,    \
@@ -401,7 +412,8 @@ Float avg_noise_effect::rectangle(
       size_t                           subgroup_id      ,    \
       size_t                           integrand_id     ,    \
       const CppAD::vector<double>&     x                ,    \
-      const CppAD::vector<Float>&      pack_vec         )    \
+      const CppAD::vector<Float>&      pack_vec         ,    \
+      work_struct&                     work             ) const \
    {  return rectangle(                                      \
          age_lower,                                         \
          age_upper,                                         \
@@ -412,8 +424,9 @@ Float avg_noise_effect::rectangle(
          integrand_id,                                      \
          x,                                                 \
          pack_vec,                                          \
-         Float ## _time_line_object_,                       \
-         Float ## _effect_                                  \
+         work.Float ## _time_line_object,                   \
+         work.Float ## _effect,                             \
+         work                                               \
       );                                                     \
    }
 
@@ -20,6 +20,7 @@ Syntax
 | |tab| *fit_simulated_data* ,
 | |tab| *meas_noise_effect* ,
 | |tab| *rate_case* ,
+| |tab| *ode_tolerance* ,
 | |tab| *bound_random* ,
 | |tab| *ode_step_size* ,
 | |tab| *age_avg_grid* ,
@@ -48,6 +49,15 @@ data_object
 ***********
 This is the ``data_model`` object being constructed.
 
+Thread Pool
+===========
+The object *data_object* contains separate
+:ref:`avg_integrand_rectangle@work` space
+for each thread in the :ref:`thread_pool-name` .
+Hence, the pool must be created before *data_object* is constructed
+(otherwise it will only have work space for one thread)
+and must not be freed while *data_object* is in use.
+
 cov2weight_map
 **************
 Is the mapping from (covariate_id, node_id, split_value) to weight_id; see
@@ -73,6 +83,12 @@ rate_case
 This is the value of
 :ref:`option_table@rate_case` in the option table.
 
+ode_tolerance
+*************
+This is the value of
+:ref:`option_table@ode_tolerance` in the option table
+(zero if it is empty).
+
 bound_random
 ************
 This is the
@@ -222,9 +238,41 @@ The arguments to this constructor are a subset of the
 arguments to the ``data_model`` constructor and are passed through
 (with the same name) to the ``avg_integrand`` constructor.
 
+avgint_work\_
+*************
+For each thread in the :ref:`thread_pool-name` ,
+this is the corresponding :ref:`avg_integrand_rectangle@work` space.
+It is constructed using the *age_avg_grid* argument.
+
+unique_subset_id\_
+******************
+For each *subset_id* , ``unique_subset_id_`` [ *subset_id* ]
+is the first subset index that has the same
+integrand_id, node_id, subgroup_id, weight_id, age and time limits,
+and covariate values as *subset_id* .
+The average integrand for these two subset indices is the same
+(they can only differ in their measurement values and densities).
+If *subset_id* is equal to ``unique_subset_id_`` [ *subset_id* ] ,
+we say that *subset_id* is unique.
+
+avgint_plan\_
+*************
+For each unique *subset_id* , this is the
+:ref:`avg_integrand_make_plan@plan` for computing the
+corresponding average integrand
+(the plan for the other subset indices is empty).
+The plans only depend on the rectangle, weighting, and integrand
+for each data point, hence they are computed once by the constructor.
+The memory for the plans is proportional to the
+number of points used to approximate the averages.
+
 {xrst_end data_model_ctor}
 -----------------------------------------------------------------------------
 */
+# include <map>
+# include <atomic>
+# include <stdexcept>
+# include <type_traits>
 # include <cppad/mixed/exception.hpp>
 # include <dismod_at/min_max_vector.hpp>
 # include <dismod_at/data_model.hpp>
@@ -235,8 +283,12 @@ arguments to the ``data_model`` constructor and are passed through
 # include <dismod_at/avgint_subset.hpp>
 # include <dismod_at/null_int.hpp>
 # include <dismod_at/error_exit.hpp>
+# include <dismod_at/thread_pool.hpp>
 
 namespace {
+   // version numbers used by set_cohort_cache
+   std::atomic<size_t> cohort_cache_version_(0);
+   //
    template <class Float>
    void print_forward_if_positive(
       const char* name    ,
@@ -268,6 +320,7 @@ data_model::data_model(
    bool                                     fit_simulated_data ,
    const std::string&                       meas_noise_effect  ,
    const std::string&                       rate_case          ,
+   double                                   ode_tolerance      ,
    double                                   bound_random       ,
    double                                   ode_step_size      ,
    const CppAD::vector<double>&             age_avg_grid       ,
@@ -297,7 +350,7 @@ avgint_obj_(
    cov2weight_obj,
    ode_step_size,
    rate_case,
-   age_avg_grid,
+   ode_tolerance,
    age_table,
    time_table,
    covariate_table,
@@ -310,7 +363,6 @@ avgint_obj_(
 ),
 avg_noise_obj_(
    ode_step_size,
-   age_avg_grid,
    age_table,
    time_table,
    subgroup_table,
@@ -318,6 +370,12 @@ avg_noise_obj_(
    w_info_vec,
    s_info_vec,
    pack_object
+),
+avgint_work_(
+   thread_pool_size(), avg_integrand::work_struct(age_avg_grid)
+),
+avg_noise_work_(
+   thread_pool_size(), avg_noise_effect::work_struct(age_avg_grid)
 )
 {  assert( bound_random >= 0.0 );
    assert( n_child_ == pack_object.child_size() );
@@ -370,6 +428,48 @@ avg_noise_obj_(
       subset_data_obj_[i].time_upper   = subset_object[i].time_upper;
    }
    // -----------------------------------------------------------------------
+   // unique_subset_id_
+   unique_subset_id_.resize(n_subset);
+   {  // key for the average integrand corresponding to a subset_id
+      std::map< std::vector<double>, size_t > key2subset_id;
+      std::vector<double> key(9 + n_covariate);
+      for(size_t i = 0; i < n_subset; ++i)
+      {  key[0] = double( subset_object[i].integrand_id );
+         key[1] = double( subset_object[i].node_id );
+         key[2] = double( subset_object[i].subgroup_id );
+         key[3] = double( subset_object[i].weight_id );
+         key[4] = subset_object[i].age_lower;
+         key[5] = subset_object[i].age_upper;
+         key[6] = subset_object[i].time_lower;
+         key[7] = subset_object[i].time_upper;
+         key[8] = double( child_info4data.table_id2child(
+            size_t( subset_object[i].original_id )
+         ) );
+         for(size_t j = 0; j < n_covariate; ++j)
+            key[9 + j] = subset_cov_value[i * n_covariate + j];
+         //
+         // insert does not change the map if this key is already present
+         unique_subset_id_[i] = key2subset_id.insert(
+            std::make_pair(key, i)
+         ).first->second;
+      }
+   }
+   // -----------------------------------------------------------------------
+   // avgint_plan_
+   avgint_plan_.resize(n_subset);
+   for(size_t i = 0; i < n_subset; i++) if( unique_subset_id_[i] == i )
+   {  avgint_obj_.make_plan(
+         subset_object[i].age_lower,
+         subset_object[i].age_upper,
+         subset_object[i].time_lower,
+         subset_object[i].time_upper,
+         size_t( subset_object[i].weight_id ),
+         size_t( subset_object[i].integrand_id ),
+         avgint_plan_[i],
+         avgint_work_[0]
+      );
+   }
+   // -----------------------------------------------------------------------
    // data_info_
    //
    // has same size as subset_data_obj
@@ -615,7 +715,8 @@ Data Model: Compute One Average Integrand
 
 Syntax
 ******
-*avg* = *data_object* . ``average`` ( *subset_id* , *pack_vec* )
+| *data_object* . ``set_cohort_cache`` ( *on* )
+| *avg* = *data_object* . ``average`` ( *subset_id* , *pack_vec* )
 
 data_object
 ***********
@@ -658,6 +759,23 @@ The return value has prototype
 This is the
 :ref:`average integrand<avg_integrand@Average Integrand, A_i>`
 for the specified data point.
+
+Cohort Cache
+************
+If *on* is true, the ``double`` version of ``average``
+caches the cohort solutions; see
+:ref:`avg_integrand_plan_avg@Cohort Cache` .
+The cached values are only valid for one value of *pack_vec* ,
+so ``set_cohort_cache`` ( ``true`` ) must be called each time
+*pack_vec* changes.
+If *on* is false, the cache is not used.
+This is the default and is correct no matter how *pack_vec* changes.
+If we are in parallel mode; see
+:ref:`thread_pool@thread_pool_in_parallel` ,
+this only affects calls to ``average`` by the current thread.
+Otherwise it affects all the threads.
+The :ref:`data_model_like_all-name` ``double`` routine
+turns the cache on during its evaluation and off when it is done.
 {xrst_toc_hidden
    example/devel/model/avg_no_ode_xam.cpp
    example/devel/model/avg_yes_ode_xam.cpp
@@ -670,20 +788,32 @@ contain examples using this routine.
 
 {xrst_end data_model_average}
 */
+void data_model::set_cohort_cache(bool on)
+{  // a new version for each pack_vec that is cached
+   size_t version = 0;
+   if( on )
+      version = ++cohort_cache_version_;
+   if( thread_pool_in_parallel() )
+   {  size_t thread = thread_pool_num();
+      assert( thread < avgint_work_.size() );
+      avgint_work_[thread].pack_version = version;
+   }
+   else
+   {  for(size_t thread = 0; thread < avgint_work_.size(); ++thread)
+         avgint_work_[thread].pack_version = version;
+   }
+}
 template <class Float>
 Float data_model::average(
    size_t                        subset_id ,
    const CppAD::vector<Float>&   pack_vec  )
 {
-   // arguments to avg_integrand::rectangle
+   // subset_id with the same average integrand that has a plan
+   subset_id = unique_subset_id_[subset_id];
+   //
+   // arguments to avg_integrand::plan_avg
    const subset_data_struct& data_item = subset_data_obj_[subset_id];
-   double age_lower    = data_item.age_lower;
-   double age_upper    = data_item.age_upper;
-   double time_lower   = data_item.time_lower;
-   double time_upper   = data_item.time_upper;
    size_t node_id      = size_t( data_item.node_id );
-   size_t weight_id    = size_t( data_item.weight_id );
-   size_t integrand_id = size_t( data_item.integrand_id );
    size_t subgroup_id  = size_t( data_item.subgroup_id );
    size_t child        = size_t( data_info_[subset_id].child );
    CppAD::vector<double> x(n_covariate_);
@@ -691,19 +821,17 @@ Float data_model::average(
       x[j] = subset_cov_value_[subset_id * n_covariate_ + j];
    //
    // compute average integrand
-   Float result = avgint_obj_.rectangle(
+   size_t thread = thread_pool_num();
+   assert( thread < avgint_work_.size() );
+   Float result = avgint_obj_.plan_avg(
       node_id,
-      age_lower,
-      age_upper,
-      time_lower,
-      time_upper,
-      weight_id,
-      integrand_id,
       n_child_,
       child,
       subgroup_id,
       x,
-      pack_vec
+      pack_vec,
+      avgint_plan_[subset_id],
+      avgint_work_[thread]
    );
    //
    assert( ! CppAD::isnan(result) );
@@ -819,6 +947,14 @@ The return value has prototype
 see :ref:`residual_density@residual@residual_struct` .
 It contains the weighted residual and the corresponding log-density.
 
+Errors
+******
+If an error is detected in parallel mode; see
+:ref:`thread_pool@thread_pool_in_parallel` ,
+a ``std::runtime_error`` is thrown (because :ref:`error_exit-name` is not
+thread safe) and the caller of :ref:`thread_pool@thread_pool_run`
+must report it. Otherwise ``error_exit`` is called.
+
 index
 =====
 Note that the :ref:`residual_density@index` field is set to
@@ -867,10 +1003,15 @@ residual_struct<Float> data_model::like_one(
    {  int data_id = subset_data_obj_[subset_id].original_id;
       std::string msg = "like_one: density = binomial, average integrand = ";
       msg += CppAD::to_string(avg) + " data_id = " + CppAD::to_string(data_id);
+      // error_exit is not thread safe
+      if( thread_pool_in_parallel() )
+         throw std::runtime_error(msg);
       error_exit(msg);
    }
    //
    // average noise effect
+   size_t thread = thread_pool_num();
+   assert( thread < avg_noise_work_.size() );
    Float std_effect = avg_noise_obj_.rectangle(
       age_lower,
       age_upper,
@@ -880,7 +1021,8 @@ residual_struct<Float> data_model::like_one(
       subgroup_id,
       integrand_id,
       x,
-      pack_vec
+      pack_vec,
+      avg_noise_work_[thread]
    );
    //
    // Delta
@@ -1005,6 +1147,18 @@ Float
 The type *Float* must be ``double`` or
 :ref:`a1_double-name` .
 
+Parallel
+========
+If *Float* is ``double`` , the data points are evaluated in parallel
+using the :ref:`thread_pool-name` .
+If *Float* is ``a1_double`` , the evaluation is sequential because
+``a1_double`` operations are being recorded.
+In either case, the resulting *residual_vec* does not depend on the
+number of threads.
+Errors that are detected by ``like_one`` in parallel mode
+are reported (using :ref:`error_exit-name` ) by the calling thread
+after all the jobs are done.
+
 hold_out
 ********
 This argument has prototype
@@ -1073,6 +1227,13 @@ The log of the density
 for the data that is included,
 is the sum of the log of the densities corresponding to all the
 :ref:`residuals<residual_density-name>` in *residual_vec* .
+
+Duplicate Averages
+******************
+Data points that have the same integrand, node, subgroup, weighting,
+age and time limits, and covariate values have the same average integrand.
+The average is only computed once for each such set of data points
+(and only recorded once when *Float* is ``a1_double`` ).
 {xrst_toc_hidden
    example/devel/model/like_all_xam.cpp
 }
@@ -1089,8 +1250,8 @@ CppAD::vector< residual_struct<Float> > data_model::like_all(
    const CppAD::vector<Float>& pack_vec      )
 {  assert( replace_like_called_ );
    //
-   // loop over the subsampled data
-   CppAD::vector< residual_struct<Float> > residual_vec;
+   // keep_subset_id: subset_id for the residuals that are included
+   CppAD::vector<size_t> keep_subset_id;
    for(size_t subset_id = 0; subset_id < subset_data_obj_.size(); subset_id++)
    {  bool keep = hold_out == false;
       keep     |= subset_data_obj_[subset_id].hold_out == 0;
@@ -1100,14 +1261,71 @@ CppAD::vector< residual_struct<Float> > data_model::like_all(
          keep &= data_info_[subset_id].depend_on_ran_var == false;
       assert( data_info_[subset_id].child <= n_child_ );
       if( keep )
-      {  Float avg = average(subset_id, pack_vec);
-
-         // compute its residual and log likelihood
-         Float not_used;
-         residual_struct<Float> residual =
-            like_one(subset_id, pack_vec, avg, not_used);
-         residual_vec.push_back( residual );
+         keep_subset_id.push_back( subset_id );
+   }
+   size_t n_keep = keep_subset_id.size();
+   //
+   // avg_subset_id: unique subset_id for the averages that are needed
+   size_t n_subset = subset_data_obj_.size();
+   CppAD::vector<bool>   need_avg(n_subset);
+   CppAD::vector<size_t> avg_subset_id;
+   for(size_t subset_id = 0; subset_id < n_subset; ++subset_id)
+      need_avg[subset_id] = false;
+   for(size_t keep_index = 0; keep_index < n_keep; ++keep_index)
+   {  size_t unique_id = unique_subset_id_[ keep_subset_id[keep_index] ];
+      if( ! need_avg[unique_id] )
+      {  need_avg[unique_id] = true;
+         avg_subset_id.push_back(unique_id);
+      }
+   }
+   size_t n_avg = avg_subset_id.size();
+   //
+   // avg_vec
+   // average integrand for each unique subset_id that is needed;
+   // i.e., only one average is computed (or recorded) for each unique id
+   CppAD::vector<Float> avg_vec(n_subset);
+   auto avg_job = [&](size_t avg_index)
+   {  size_t subset_id  = avg_subset_id[avg_index];
+      avg_vec[subset_id] = average(subset_id, pack_vec);
+   };
+   //
+   // residual_vec
+   CppAD::vector< residual_struct<Float> > residual_vec(n_keep);
+   //
+   // like_job
+   // computes the residual and log likelihood for one kept data point
+   auto like_job = [&](size_t keep_index)
+   {  size_t subset_id = keep_subset_id[keep_index];
+      const Float& avg = avg_vec[ unique_subset_id_[subset_id] ];
+      Float  not_used;
+      residual_vec[keep_index] =
+         like_one(subset_id, pack_vec, avg, not_used);
+   };
+   //
+   // a1_double operations are being recorded and cannot be done in parallel
+   if( std::is_same<Float, double>::value )
+   {  // cohort solutions are cached for this pack_vec
+      set_cohort_cache(true);
+      //
+      // errors detected in parallel mode are reported here
+      try
+      {  thread_pool_run(n_avg, avg_job);
+         thread_pool_run(n_keep, like_job);
+      }
+      catch(const std::runtime_error& e)
+      {  error_exit( e.what() );
       }
+      catch(...)
+      {  set_cohort_cache(false);
+         throw;
+      }
+      set_cohort_cache(false);
+   }
+   else
+   {  for(size_t avg_index = 0; avg_index < n_avg; ++avg_index)
+         avg_job(avg_index);
+      for(size_t keep_index = 0; keep_index < n_keep; ++keep_index)
+         like_job(keep_index);
    }
    return residual_vec;
 }
@@ -1120,6 +1338,7 @@ template data_model::data_model(                                   \
    bool                                     fit_simulated_data ,  \
    const std::string&                       meas_noise_effect  ,  \
    const std::string&                       rate_case          ,  \
+   double                                   ode_tolerance      ,  \
    double                                   bound_random       ,  \
    double                                   ode_step_size      ,  \
    const CppAD::vector<double>&             age_avg_grid       ,  \
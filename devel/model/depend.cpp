@@ -5,6 +5,7 @@
 // ----------------------------------------------------------------------------
 # include <dismod_at/depend.hpp>
 # include <dismod_at/a1_double.hpp>
+# include <dismod_at/ode2_chkpoint.hpp>
 
 namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
 /*
@@ -55,6 +56,9 @@ CppAD::vector<bool> data_depend(
 {
    typedef CppAD::vector<a1_double> a1_vector;
    //
+   // the data likelihood may use ode2_chkpoint
+   ode2_chkpoint_setup();
+   //
    // declare a1_pack_vec to be independent variable vector
    size_t n_var = pack_vec.size();
    a1_vector a1_pack_vec(n_var);
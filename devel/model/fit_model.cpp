@@ -14,6 +14,7 @@
 # include <dismod_at/get_var_limits.hpp>
 # include <dismod_at/ran_con_rcv.hpp>
 # include <dismod_at/get_str_map.hpp>
+# include <dismod_at/ode2_chkpoint.hpp>
 
 # define PRINT_SIZE_MAP 0
 
@@ -320,6 +321,10 @@ data_object_   ( data_object )
    CppAD::vector<double> cppad_mixed_random_vec =
       random_const_.remove( random_vec );
    //
+   // the ODE step checkpoint functions must be recorded before
+   // initialize starts recording the a1_double likelihood tapes
+   ode2_chkpoint_setup();
+   //
    cppad_mixed_info_ = initialize(fixed_vec, cppad_mixed_random_vec);
 # if PRINT_SIZE_MAP
    std::map<std::string, size_t>::iterator itr;
@@ -806,6 +811,103 @@ CppAD::mixed::d_sparse_rcv fit_model::random_obj_hes(
 }
 /*
 ---------------------------------------------------------------------------
+{xrst_begin fit_model_fixed_obj_hes dev}
+{xrst_spell
+   rcv
+}
+
+Compute Hessian Of Fixed Effects Objective
+##########################################
+
+Syntax
+******
+
+   ``fixed_hes_rcv`` = *fit_object* . ``fixed_obj_hes`` ( *pack_vec* )
+
+Prototype
+*********
+{xrst_literal
+   // BEGIN_FIXED_OBJ_HES
+   // END_FIXED_OBJ_HES
+}
+
+Constants
+*********
+The model variables that have upper and lower limits equal
+are referred to as constants.
+
+pack_vec
+********
+Is the value of the model variables,
+in :ref:`pack_info-name` order, at which we are computing the Hessian.
+The corresponding fixed effects are referred to as :math:`\theta`
+and the random effects are referred to as :math:`u` below.
+It is assumed that :math:`u` minimizes the random effects objective
+:math:`f( \theta , \cdot )`.
+
+fixed_hes_rcv
+*************
+is a sparse matrix representation of the
+Hessian of the fixed effects objective evaluated at :math:`\theta`.
+The row and column indices in this matrix are relative to the
+:ref:`pack_info-name` vector.
+Only the lower triangle is returned (column indices are less than or equal
+row indices) because the Hessian is symmetric.
+The Laplace density terms in the likelihood function are not included
+because the Hessian is not defined at zero for an Laplace density.
+
+Constraints
+===========
+Variables that are constants are included in *fixed_hes_rcv* .
+This is the Hessian that cppad_mixed uses to sample the fixed effects.
+:ref:`fit_model_sample_posterior@hes_fixed_obj_out`
+is the same as *fixed_hes_rcv* except that the constants are not included.
+
+{xrst_end fit_model_fixed_obj_hes}
+*/
+// BEGIN_FIXED_OBJ_HES
+CppAD::mixed::d_sparse_rcv fit_model::fixed_obj_hes(
+   const CppAD::vector<double>&  pack_vec )
+// END_FIXED_OBJ_HES
+{  size_t n_var = n_fixed_ + n_random_;
+   assert( pack_vec.size() == n_var );
+   //
+   // fixed_vec, random_vec
+   CppAD::vector<double> fixed_vec(n_fixed_), random_vec(n_random_);
+   unpack_random(pack_object_, pack_vec, random_vec);
+   unpack_fixed(pack_object_,   pack_vec, fixed_vec);
+   //
+   // convert dismod_at random effects to cppad_mixed random effects
+   d_vector cppad_mixed_random_vec = random_const_.remove( random_vec );
+   //
+   // convert dismod_at fixed effect to cppad_mixed fixed effects
+   d_vector cppad_mixed_fixed_vec(n_fixed_);
+   scale_fixed_effect(fixed_vec, cppad_mixed_fixed_vec);
+   //
+   // hes_fixed_obj_rcv
+   // This Hessian uses variable indices in cppad_mixed space
+   CppAD::mixed::d_sparse_rcv hes_fixed_obj_rcv = hes_fixed_obj(
+      cppad_mixed_fixed_vec, cppad_mixed_random_vec
+   );
+   //
+   // fixed_hes_rcv
+   // This Hessian uses variable indices in dismod_at space
+   CppAD::vector<size_t> var_id = fixed2var_id(pack_object_);
+   size_t nnz = hes_fixed_obj_rcv.nnz();
+   CppAD::mixed::sparse_rc pattern(n_var, n_var, nnz);
+   for(size_t k = 0; k < nnz; ++k)
+   {  size_t r = hes_fixed_obj_rcv.row()[k];
+      size_t c = hes_fixed_obj_rcv.col()[k];
+      pattern.set(k, var_id[r], var_id[c]);
+   }
+   CppAD::mixed::d_sparse_rcv fixed_hes_rcv( pattern );
+   for(size_t k = 0; k < nnz; ++k)
+      fixed_hes_rcv.set(k, hes_fixed_obj_rcv.val()[k] );
+   //
+   return fixed_hes_rcv;
+}
+/*
+---------------------------------------------------------------------------
 {xrst_begin fit_model_sample_posterior dev}
 {xrst_spell
    covariance
@@ -852,7 +954,11 @@ It is assumed that :math:`\hat{u}` minimizes the random effects objective
 
 hes_fixed_obj_out
 *****************
-The input value of this argument does not matter.
+If the input value of *hes_fixed_obj_out* .\ ``nr`` () is
+the number of model variables, it is assumed to be the value
+returned by :ref:`fit_model_fixed_obj_hes-name` at
+*fit_var_value* and the Hessian is not recomputed.
+Otherwise the input value of this argument does not matter.
 Upon return it is a sparse matrix representation of the
 Hessian of the fixed effects objective evaluated at :math:`\theta`.
 The row and column indices in this matrix are relative to the
@@ -866,7 +972,12 @@ because the Hessian is not defined at zero for an Laplace density.
 
 hes_random_obj_out
 ******************
-The input value of this argument does not matter.
+If the input value of *hes_random_obj_out* .\ ``nr`` () is
+the number of model variables, it is assumed to be the value
+this argument would have upon return and the Hessian is not recomputed;
+e.g., it was computed by :ref:`fit_model_random_obj_hes-name` at
+*fit_var_value* .
+Otherwise the input value of this argument does not matter.
 Upon return it is a sparse matrix representation of the
 Hessian of the random effects objective evaluated
 :math:`( \theta , \hat{u} )`.
@@ -943,13 +1054,9 @@ void fit_model::sample_posterior(
    sample_out.resize(0);
 
    //
-   // fixed_vec, random_opt
-   CppAD::vector<double> fixed_vec(n_fixed_), random_opt(n_random_);
-   unpack_random(pack_object_, fit_var_value, random_opt);
-   unpack_fixed(pack_object_,   fit_var_value, fixed_vec);
-   //
-   // convert dismod_at random effects to cppad_mixed random effects
-   d_vector cppad_mixed_random_opt = random_const_.remove( random_opt );
+   // fixed_vec
+   CppAD::vector<double> fixed_vec(n_fixed_);
+   unpack_fixed(pack_object_, fit_var_value, fixed_vec);
    //
    // convert dismod_at fixed effect to cppad_mixed fixed effects
    d_vector cppad_mixed_fixed_vec(n_fixed_);
@@ -959,14 +1066,45 @@ void fit_model::sample_posterior(
    CppAD::mixed::fixed_solution solution;
    solution.fixed_opt = cppad_mixed_fixed_vec;
    //
+   // hes_fixed_obj_in
+   // Hessian of the fixed effects objective including the constants
+   CppAD::mixed::d_sparse_rcv hes_fixed_obj_in;
+   if( hes_fixed_obj_out.nr() == n_var )
+      hes_fixed_obj_in = hes_fixed_obj_out;
+   else
+      hes_fixed_obj_in = fixed_obj_hes(fit_var_value);
+   assert( hes_fixed_obj_in.nc() == n_var );
+   //
+   // hes_random_obj_out
+   // (sample_random does its own factorization of this Hessian)
+   if( hes_random_obj_out.nr() != n_var )
+      hes_random_obj_out = random_obj_hes(fit_var_value);
+   assert( hes_random_obj_out.nc() == n_var );
+   //
    // hes_fixed_obj_rcv
-   CppAD::mixed::d_sparse_rcv hes_fixed_obj_rcv = hes_fixed_obj(
-      cppad_mixed_fixed_vec, cppad_mixed_random_opt
-   );
-   // hes_random_obj_rcv
-   CppAD::mixed::d_sparse_rcv hes_random_obj_rcv = hes_random_obj(
-      cppad_mixed_fixed_vec, cppad_mixed_random_opt
-   );
+   // This Hessian uses variable indices in cppad_mixed space
+   CppAD::mixed::d_sparse_rcv hes_fixed_obj_rcv;
+   {  CppAD::vector<size_t> var_id = fixed2var_id(pack_object_);
+      CppAD::vector<size_t> fixed_index(n_var);
+      for(size_t i = 0; i < n_var; ++i)
+         fixed_index[i] = DISMOD_AT_NULL_SIZE_T;
+      for(size_t j = 0; j < n_fixed_; ++j)
+         fixed_index[ var_id[j] ] = j;
+      //
+      size_t nnz = hes_fixed_obj_in.nnz();
+      CppAD::mixed::sparse_rc pattern(n_fixed_, n_fixed_, nnz);
+      for(size_t k = 0; k < nnz; ++k)
+      {  size_t r = fixed_index[ hes_fixed_obj_in.row()[k] ];
+         size_t c = fixed_index[ hes_fixed_obj_in.col()[k] ];
+         assert( r < n_fixed_ && c < n_fixed_ );
+         pattern.set(k, r, c);
+      }
+      CppAD::mixed::d_sparse_rcv info( pattern );
+      for(size_t k = 0; k < nnz; ++k)
+         info.set(k, hes_fixed_obj_in.val()[k] );
+      //
+      hes_fixed_obj_rcv = info;
+   }
    //
    // var_lower, var_upper
    d_vector var_lower(n_var), var_upper(n_var);
@@ -975,16 +1113,12 @@ void fit_model::sample_posterior(
    );
    //
    // hes_fixed_obj_out
-   {  CppAD::vector<size_t> var_id = fixed2var_id(pack_object_);
-      size_t nnz   = hes_fixed_obj_rcv.nnz();
+   {  size_t nnz   = hes_fixed_obj_in.nnz();
       CppAD::vector<bool> both_variable(nnz);
       size_t n_both_variable = 0;
       for(size_t k = 0; k < nnz; ++k)
-      {  size_t r = hes_fixed_obj_rcv.row()[k];
-         size_t c = hes_fixed_obj_rcv.col()[k];
-         //
-         size_t i = var_id[r];
-         size_t j = var_id[c];
+      {  size_t i = hes_fixed_obj_in.row()[k];
+         size_t j = hes_fixed_obj_in.col()[k];
          //
          both_variable[k]  = var_lower[i] < var_upper[i];
          both_variable[k] &= var_lower[j] < var_upper[j];
@@ -995,33 +1129,18 @@ void fit_model::sample_posterior(
       CppAD::mixed::sparse_rc pattern(n_var, n_var, n_both_variable);
       size_t count = 0;
       for(size_t k = 0; k < nnz; ++k) if( both_variable[k] )
-      {  size_t r = hes_fixed_obj_rcv.row()[k];
-         size_t c = hes_fixed_obj_rcv.col()[k];
-         pattern.set(count++, var_id[r], var_id[c]);
+      {  size_t i = hes_fixed_obj_in.row()[k];
+         size_t j = hes_fixed_obj_in.col()[k];
+         pattern.set(count++, i, j);
       }
       assert( count == n_both_variable);
       CppAD::mixed::d_sparse_rcv info( pattern );
       count = 0;
       for(size_t k = 0; k < nnz; ++k) if( both_variable[k] )
-         info.set(count++, hes_fixed_obj_rcv.val()[k] );
+         info.set(count++, hes_fixed_obj_in.val()[k] );
       //
       hes_fixed_obj_out = info;
    }
-   // hes_random_obj_out
-   {  CppAD::vector<size_t> var_id = random2var_id(pack_object_);
-      size_t nnz = hes_random_obj_rcv.nnz();
-      CppAD::mixed::sparse_rc pattern(n_var, n_var, nnz);
-      for(size_t k = 0; k < nnz; ++k)
-      {  size_t r = hes_random_obj_rcv.row()[k];
-         size_t c = hes_random_obj_rcv.col()[k];
-         pattern.set(k, var_id[r], var_id[c]);
-      }
-      CppAD::mixed::d_sparse_rcv info( pattern );
-      for(size_t k = 0; k < nnz; ++k)
-         info.set(k, hes_random_obj_rcv.val()[k] );
-      //
-      hes_random_obj_out = info;
-   }
    //
    // cppad_mixed_fixed_lower
    CppAD::vector<double> pack_vec( n_var );
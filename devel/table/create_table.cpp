@@ -18,10 +18,21 @@ Syntax
 | ``dismod_at.create_table`` (
 | |tab| *db* , *table_name* , *col_name* , *col_type* , *col_unique* , *row_value*
 | )
+| ``dismod_at.create_table`` (
+| |tab| *db* , *table_name* , *col_name* , *col_type* , *col_unique* ,
+| |tab| *n_row* , *int_value* , *real_value*
+| )
 
 Purpose
 *******
 Create a table and place data in the table.
+The first syntax specifies the values as strings that are
+used to construct an sql command.
+The second syntax specifies the values by column,
+binds them to a prepared ``insert`` statement,
+and writes all the rows in one transaction.
+It does not convert the values to strings and
+is much faster for large tables.
 
 db
 **
@@ -100,6 +111,56 @@ Note that the special case where the value is the empty string,
 and the type is ``integer`` or ``real`` , the ``null``
 value is placed at the corresponding location in the table.
 
+n_row
+*****
+This argument has prototype
+
+   ``size_t`` *n_row*
+
+and is the number of rows in the table.
+
+int_value
+*********
+This argument has prototype
+
+   ``const CppAD::vector<int>&`` *int_value*
+
+We use *n_int* for the number of columns that have
+*col_type* equal to ``integer`` .
+The size of *int_value* is *n_int* * *n_row* .
+For *k* = 0 , ..., *n_int* ``-1`` ,
+*i* = 0 , ..., *n_row* ``-1`` ,
+
+   *int_value* [ ``k`` * *n_row* + *i*  ]
+
+is the value placed in the *i*-th row of the *k*-th integer column
+(in the same order as *col_name* ).
+If this value is ``DISMOD_AT_NULL_INT`` ,
+``null`` is placed at the corresponding location in the table.
+
+real_value
+**********
+This argument has prototype
+
+   ``const CppAD::vector<double>&`` *real_value*
+
+We use *n_real* for the number of columns that have
+*col_type* equal to ``real`` .
+The size of *real_value* is *n_real* * *n_row* .
+For *k* = 0 , ..., *n_real* ``-1`` ,
+*i* = 0 , ..., *n_row* ``-1`` ,
+
+   *real_value* [ ``k`` * *n_row* + *i*  ]
+
+is the value placed in the *i*-th row of the *k*-th real column
+(in the same order as *col_name* ).
+If this value is nan,
+``null`` is placed at the corresponding location in the table.
+
+text
+====
+The second syntax does not support columns with type ``text`` .
+
 table_name_id
 *************
 A column with name *table_name* _ ``id`` and type
@@ -112,14 +173,17 @@ increment by one for each row.
 Example
 *******
 The file :ref:`create_table_xam.cpp-name` is an example use of
-``cpp_create_table`` .
+both syntaxes for ``cpp_create_table`` .
 
 {xrst_end cpp_create_table}
 ---------------------------------------------------------------------------
 */
+# include <algorithm>
 # include <dismod_at/create_table.hpp>
 # include <cppad/utility/to_string.hpp>
 # include <dismod_at/exec_sql_cmd.hpp>
+# include <dismod_at/table_writer.hpp>
+# include <dismod_at/null_int.hpp>
 
 namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
 
@@ -181,4 +245,54 @@ void create_table(
    dismod_at::exec_sql_cmd(db, cmd);
 }
 
+void create_table(
+   sqlite3*                            db             ,
+   const std::string&                  table_name     ,
+   const CppAD::vector<std::string>&   col_name       ,
+   const CppAD::vector<std::string>&   col_type       ,
+   const CppAD::vector<bool>&          col_unique     ,
+   size_t                              n_row          ,
+   const CppAD::vector<int>&           int_value      ,
+   const CppAD::vector<double>&        real_value     )
+{  size_t n_col = col_name.size();
+   assert( col_type.size() == n_col );
+   assert( col_unique.size() == n_col );
+   //
+   // offset for each column in int_value or real_value
+   CppAD::vector<size_t> offset(n_col);
+   size_t n_int  = 0;
+   size_t n_real = 0;
+   for(size_t j = 0; j < n_col; ++j)
+   {  if( col_type[j] == "integer" )
+         offset[j] = n_row * n_int++;
+      else
+      {  assert( col_type[j] == "real" );
+         offset[j] = n_row * n_real++;
+      }
+   }
+   assert( int_value.size() == n_int * n_row );
+   assert( real_value.size() == n_real * n_row );
+   //
+   // write all the rows in one transaction
+   size_t n_commit = std::max(n_row, size_t(1));
+   table_writer writer(
+      db, table_name, col_name, col_type, col_unique, n_commit
+   );
+   for(size_t i = 0; i < n_row; ++i)
+   {  for(size_t j = 0; j < n_col; ++j)
+      {  if( col_type[j] == "integer" )
+         {  int value = int_value[ offset[j] + i ];
+            if( value == DISMOD_AT_NULL_INT )
+               writer.set_null(j);
+            else
+               writer.set_integer(j, value);
+         }
+         else
+            writer.set_real(j, real_value[ offset[j] + i ] );
+      }
+      writer.next_row();
+   }
+   writer.close();
+}
+
 } // END_DISMOD_AT_NAMESPACE
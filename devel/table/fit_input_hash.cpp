@@ -0,0 +1,204 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-23 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin fit_input_hash dev}
+{xrst_spell
+   hpp
+   fnv
+}
+
+Hash Code for the Tables That Determine a Fit
+#############################################
+
+Syntax
+******
+
+| ``# include <dismod_at/fit_input_hash.hpp>``
+| *input_hash* = ``fit_input_hash`` ( *db* , *option_map* )
+
+Prototype
+*********
+{xrst_literal
+   // BEGIN_PROTOTYPE
+   // END_PROTOTYPE
+}
+
+db
+**
+The argument *db* is an open connection to the database.
+
+option_map
+**********
+This maps the option names in the :ref:`option_table-name`
+to their values.
+If :ref:`option_table@Other Database@other_database` is not empty,
+the tables in
+:ref:`option_table@Other Database@other_input_table`
+are read from the other database.
+
+Tables
+******
+The hash code depends on every value in the following tables:
+the :ref:`input tables<input-name>` (except for the avgint table),
+the :ref:`data_subset_table-name` ,
+the :ref:`bnd_mulcov_table-name` , and the :ref:`data_sim_table-name` .
+A table that does not exist is treated as having no rows.
+Hence changing the options, priors, or data,
+or running a :ref:`hold_out_command-name` changes the hash code
+(except in the unlikely case of a collision).
+
+input_hash
+**********
+The return value is the hash code.
+It is an integer value, less than :math:`2^{52}`,
+so that it can be stored as a ``double`` without rounding.
+The FNV-1a algorithm is used, so the hash code does not depend
+on the build of dismod_at.
+
+{xrst_end fit_input_hash}
+*/
+# include <cstdint>
+# include <dismod_at/fit_input_hash.hpp>
+# include <dismod_at/does_table_exist.hpp>
+# include <dismod_at/open_connection.hpp>
+# include <dismod_at/get_str_map.hpp>
+# include <dismod_at/error_exit.hpp>
+
+namespace {
+   // fnv_1a
+   // update the hash code using n_byte bytes starting at data
+   void fnv_1a(uint64_t& code, const void* data, size_t n_byte)
+   {  const unsigned char* byte = reinterpret_cast<const unsigned char*>(data);
+      for(size_t i = 0; i < n_byte; ++i)
+      {  code ^= uint64_t( byte[i] );
+         code *= uint64_t( 1099511628211ULL );
+      }
+   }
+   // hash_table
+   // update the hash code using the name and every value in a table
+   void hash_table(uint64_t& code, sqlite3* db, const std::string& table_name)
+   {  fnv_1a(code, table_name.c_str(), table_name.size() + 1);
+      if( ! dismod_at::does_table_exist(db, table_name) )
+         return;
+      //
+      // prepare sqlite command
+      std::string cmd = "select * from " + table_name;
+      sqlite3_stmt* p_stmt;
+      int           n_byte = -1;
+      const char**  pz_tail = nullptr;
+      int rc = sqlite3_prepare_v2(db, cmd.c_str(), n_byte, &p_stmt, pz_tail);
+      if( rc != SQLITE_OK )
+      {  std::string message = "fit_input_hash: following command failed:\n";
+         message            += cmd;
+         dismod_at::error_exit(message);
+      }
+      //
+      // hash each value in each row
+      int n_col = sqlite3_column_count(p_stmt);
+      rc        = sqlite3_step(p_stmt);
+      while( rc == SQLITE_ROW )
+      {  for(int j = 0; j < n_col; ++j)
+         {  int type = sqlite3_column_type(p_stmt, j);
+            fnv_1a(code, &type, sizeof(type) );
+            if( type == SQLITE_INTEGER )
+            {  sqlite3_int64 value = sqlite3_column_int64(p_stmt, j);
+               fnv_1a(code, &value, sizeof(value) );
+            }
+            else if( type == SQLITE_FLOAT )
+            {  double value = sqlite3_column_double(p_stmt, j);
+               fnv_1a(code, &value, sizeof(value) );
+            }
+            else if( type != SQLITE_NULL )
+            {  // text and blob values
+               const void* data = sqlite3_column_blob(p_stmt, j);
+               n_byte           = sqlite3_column_bytes(p_stmt, j);
+               fnv_1a(code, data, size_t(n_byte) );
+            }
+         }
+         rc = sqlite3_step(p_stmt);
+      }
+      if( rc != SQLITE_DONE )
+      {  std::string message = "fit_input_hash: reading ";
+         message            += table_name + " table failed\n";
+         dismod_at::error_exit(message);
+      }
+      //
+      // delete the statement
+      sqlite3_finalize(p_stmt);
+   }
+}
+
+namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
+
+// BEGIN_PROTOTYPE
+double fit_input_hash(
+   sqlite3*                                    db         ,
+   const std::map<std::string, std::string>&   option_map )
+// END_PROTOTYPE
+{  //
+   // db_other, other_input_table
+   sqlite3*    db_other          = nullptr;
+   std::string other_input_table = "";
+   std::string database = get_str_map(option_map, "other_database", "");
+   if( database != "" )
+   {  bool new_file  = false;
+      db_other       = open_connection(database, new_file);
+      other_input_table  = get_str_map(option_map, "other_input_table", "");
+      other_input_table  = " " + other_input_table + " ";
+   }
+   //
+   // input tables that can be in the other database
+   const char* input_table[] = {
+      "age",
+      "covariate",
+      "data",
+      "density",
+      "integrand",
+      "mulcov",
+      "node",
+      "nslist",
+      "nslist_pair",
+      "prior",
+      "rate",
+      "rate_eff_cov",
+      "smooth",
+      "smooth_grid",
+      "subgroup",
+      "time",
+      "weight",
+      "weight_grid"
+   };
+   size_t n_input = sizeof(input_table) / sizeof(input_table[0]);
+   //
+   // tables that are always in this database
+   const char* db_table[] = {
+      "option",
+      "data_subset",
+      "bnd_mulcov",
+      "data_sim"
+   };
+   size_t n_db = sizeof(db_table) / sizeof(db_table[0]);
+   //
+   // code: FNV-1a offset basis
+   uint64_t code = uint64_t( 14695981039346656037ULL );
+   for(size_t i = 0; i < n_input; ++i)
+   {  std::string table_name = input_table[i];
+      sqlite3* db_tmp = db;
+      if( other_input_table.find(" " + table_name + " ") != std::string::npos )
+         db_tmp = db_other;
+      hash_table(code, db_tmp, table_name);
+   }
+   for(size_t i = 0; i < n_db; ++i)
+      hash_table(code, db, db_table[i]);
+   //
+   if( db_other != nullptr )
+      sqlite3_close(db_other);
+   //
+   // input_hash
+   uint64_t mask = ( uint64_t(1) << 52 ) - 1;
+   return double( code & mask );
+}
+
+} // END_DISMOD_AT_NAMESPACE
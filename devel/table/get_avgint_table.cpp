@@ -183,78 +183,73 @@ void get_avgint_table(
 {  using std::string;
    //
    string table_name  = "avgint";
-   string column_name;
    size_t n_avgint      = check_table_id(db, table_name);
    //
+   // columns in the avgint table (not including the primary key)
+   const char* int_name[] = {
+      "integrand_id",
+      "node_id",
+      "subgroup_id",
+      "weight_id"
+   };
+   const char* real_name[] = {
+      "age_lower",
+      "age_upper",
+      "time_lower",
+      "time_upper"
+   };
+   size_t n_int  = sizeof(int_name) / sizeof(int_name[0]);
+   size_t n_real = sizeof(real_name) / sizeof(real_name[0]);
+   size_t n_col  = n_int + n_real + n_covariate;
+   CppAD::vector<string> col_name(n_col), col_type(n_col);
+   for(size_t k = 0; k < n_int; ++k)
+   {  col_name[k] = int_name[k];
+      col_type[k] = "integer";
+   }
+   for(size_t k = 0; k < n_real; ++k)
+   {  col_name[n_int + k] = real_name[k];
+      col_type[n_int + k] = "real";
+   }
+   for(size_t j = 0; j < n_covariate; j++)
+   {  std::stringstream ss;
+      ss << "x_" << j;
+      col_name[n_int + n_real + j] = ss.str();
+      col_type[n_int + n_real + j] = "real";
+   }
+   //
+   // read all the columns in one pass through the avgint table
+   CppAD::vector<int>    int_value;
+   CppAD::vector<double> real_value;
+   CppAD::vector<string> text_value;
+# ifndef NDEBUG
+   size_t n_row =
+# endif
+   get_table_column(
+      db, table_name, col_name, col_type, int_value, real_value, text_value
+   );
+   assert( n_row == n_avgint );
+   //
    // avgint_table
-   {  // read avgint_table
-
-      column_name        = "integrand_id";
-      CppAD::vector<int>    integrand_id;
-      get_table_column(db, table_name, column_name, integrand_id);
-      assert( n_avgint == integrand_id.size() );
-
-      column_name        = "node_id";
-      CppAD::vector<int>    node_id;
-      get_table_column(db, table_name, column_name, node_id);
-      assert( n_avgint == node_id.size() );
-
-      column_name        = "weight_id";
-      CppAD::vector<int>    weight_id;
-      get_table_column(db, table_name, column_name, weight_id);
-      assert( n_avgint == weight_id.size() );
-
-      column_name           =  "age_lower";
-      CppAD::vector<double>     age_lower;
-      get_table_column(db, table_name, column_name, age_lower);
-      assert( n_avgint == age_lower.size() );
-
-      column_name           =  "age_upper";
-      CppAD::vector<double>     age_upper;
-      get_table_column(db, table_name, column_name, age_upper);
-      assert( n_avgint == age_upper.size() );
-
-      column_name           =  "time_lower";
-      CppAD::vector<double>     time_lower;
-      get_table_column(db, table_name, column_name, time_lower);
-      assert( n_avgint == time_lower.size() );
-
-      column_name           =  "time_upper";
-      CppAD::vector<double>     time_upper;
-      get_table_column(db, table_name, column_name, time_upper);
-      assert( n_avgint == time_upper.size() );
-
-      column_name           = "subgroup_id";
-      CppAD::vector<int>       subgroup_id;
-      get_table_column(db, table_name, column_name, subgroup_id);
-      assert( n_avgint == subgroup_id.size() );
-
-      // set avgint_table
-      assert( avgint_table.size() == 0 );
-      avgint_table.resize(n_avgint);
-      for(size_t i = 0; i < n_avgint; i++)
-      {  avgint_table[i].integrand_id  = integrand_id[i];
-         avgint_table[i].node_id       = node_id[i];
-         avgint_table[i].subgroup_id   = subgroup_id[i];
-         avgint_table[i].weight_id     = weight_id[i];
-         avgint_table[i].age_lower     = age_lower[i];
-         avgint_table[i].age_upper     = age_upper[i];
-         avgint_table[i].time_lower    = time_lower[i];
-         avgint_table[i].time_upper    = time_upper[i];
-      }
+   assert( avgint_table.size() == 0 );
+   avgint_table.resize(n_avgint);
+   for(size_t i = 0; i < n_avgint; i++)
+   {  avgint_table[i].integrand_id  = int_value[0 * n_avgint + i];
+      avgint_table[i].node_id       = int_value[1 * n_avgint + i];
+      avgint_table[i].subgroup_id   = int_value[2 * n_avgint + i];
+      avgint_table[i].weight_id     = int_value[3 * n_avgint + i];
+      avgint_table[i].age_lower     = real_value[0 * n_avgint + i];
+      avgint_table[i].age_upper     = real_value[1 * n_avgint + i];
+      avgint_table[i].time_lower    = real_value[2 * n_avgint + i];
+      avgint_table[i].time_upper    = real_value[3 * n_avgint + i];
    }
    //
-   // set avgint_cov_value
+   // avgint_cov_value
    assert( avgint_cov_value.size() == 0 );
    avgint_cov_value.resize(n_avgint * n_covariate);
    for(size_t j = 0; j < n_covariate; j++)
-   {  std::stringstream ss;
-      ss << "x_" << j;
-      column_name = ss.str();
-      CppAD::vector<double> x_j;
-      get_table_column(db, table_name, column_name, x_j);
+   {  size_t offset = (n_real + j) * n_avgint;
       for(size_t i = 0; i < n_avgint; i++)
-         avgint_cov_value[ i * n_covariate + j ] = x_j[i];
+         avgint_cov_value[ i * n_covariate + j ] = real_value[offset + i];
    }
 
    // check for erorr conditions
@@ -206,121 +206,87 @@ void get_data_table(
 {  using std::string;
 
    string table_name  = "data";
-   string column_name;
    size_t n_data      = check_table_id(db, table_name);
    //
+   // columns in the data table (not including the primary key)
+   const char* int_name[] = {
+      "integrand_id",
+      "density_id",
+      "node_id",
+      "subgroup_id",
+      "weight_id",
+      "hold_out",
+      "sample_size"
+   };
+   const char* real_name[] = {
+      "meas_value",
+      "meas_std",
+      "eta",
+      "nu",
+      "age_lower",
+      "age_upper",
+      "time_lower",
+      "time_upper"
+   };
+   size_t n_int  = sizeof(int_name) / sizeof(int_name[0]);
+   size_t n_real = sizeof(real_name) / sizeof(real_name[0]);
+   size_t n_col  = n_int + n_real + n_covariate;
+   CppAD::vector<string> col_name(n_col), col_type(n_col);
+   for(size_t k = 0; k < n_int; ++k)
+   {  col_name[k] = int_name[k];
+      col_type[k] = "integer";
+   }
+   for(size_t k = 0; k < n_real; ++k)
+   {  col_name[n_int + k] = real_name[k];
+      col_type[n_int + k] = "real";
+   }
+   for(size_t j = 0; j < n_covariate; j++)
+   {  std::stringstream ss;
+      ss << "x_" << j;
+      col_name[n_int + n_real + j] = ss.str();
+      col_type[n_int + n_real + j] = "real";
+   }
+   //
+   // read all the columns in one pass through the data table
+   CppAD::vector<int>    int_value;
+   CppAD::vector<double> real_value;
+   CppAD::vector<string> text_value;
+# ifndef NDEBUG
+   size_t n_row =
+# endif
+   get_table_column(
+      db, table_name, col_name, col_type, int_value, real_value, text_value
+   );
+   assert( n_row == n_data );
+   //
    // data_table
-   {  // read data table
-
-      column_name = "integrand_id";
-      CppAD::vector<int>    integrand_id;
-      get_table_column(db, table_name, column_name, integrand_id);
-      assert( n_data == integrand_id.size() );
-
-      column_name        = "density_id";
-      CppAD::vector<int>    density_id;
-      get_table_column(db, table_name, column_name, density_id);
-      assert( n_data == density_id.size() );
-
-      column_name        = "hold_out";
-      CppAD::vector<int>    hold_out;
-      get_table_column(db, table_name, column_name, hold_out);
-      assert( n_data == hold_out.size() );
-
-      column_name        = "node_id";
-      CppAD::vector<int>    node_id;
-      get_table_column(db, table_name, column_name, node_id);
-      assert( n_data == node_id.size() );
-
-      column_name        = "weight_id";
-      CppAD::vector<int>    weight_id;
-      get_table_column(db, table_name, column_name, weight_id);
-      assert( n_data == weight_id.size() );
-
-      column_name           =  "meas_value";
-      CppAD::vector<double>     meas_value;
-      get_table_column(db, table_name, column_name, meas_value);
-      assert( n_data == meas_value.size() );
-
-      column_name           =  "meas_std";
-      CppAD::vector<double>     meas_std;
-      get_table_column(db, table_name, column_name, meas_std);
-      assert( n_data == meas_std.size() );
-
-      column_name           =  "eta";
-      CppAD::vector<double>     eta;
-      get_table_column(db, table_name, column_name, eta);
-      assert( n_data == eta.size() );
-
-      column_name           =  "nu";
-      CppAD::vector<double>     nu;
-      get_table_column(db, table_name, column_name, nu);
-      assert( n_data == nu.size() );
-
-      column_name           =  "sample_size";
-      CppAD::vector<int>     sample_size;
-      get_table_column(db, table_name, column_name, sample_size);
-      assert( n_data == sample_size.size() );
-
-      column_name           =  "age_lower";
-      CppAD::vector<double>     age_lower;
-      get_table_column(db, table_name, column_name, age_lower);
-      assert( n_data == age_lower.size() );
-
-      column_name           =  "age_upper";
-      CppAD::vector<double>     age_upper;
-      get_table_column(db, table_name, column_name, age_upper);
-      assert( n_data == age_upper.size() );
-
-      column_name           =  "time_lower";
-      CppAD::vector<double>     time_lower;
-      get_table_column(db, table_name, column_name, time_lower);
-      assert( n_data == time_lower.size() );
-
-      column_name           =  "time_upper";
-      CppAD::vector<double>     time_upper;
-      get_table_column(db, table_name, column_name, time_upper);
-      assert( n_data == time_upper.size() );
-
-      column_name           = "subgroup_id";
-      CppAD::vector<int>       subgroup_id;
-      get_table_column(db, table_name, column_name, subgroup_id);
-      assert( n_data == subgroup_id.size() );
-
-      // set data_table
-      assert( data_table.size() == 0 );
-      data_table.resize(n_data);
-      for(size_t i = 0; i < n_data; i++)
-      {
-         data_table[i].integrand_id  = integrand_id[i];
-         data_table[i].density_id    = density_id[i];
-         data_table[i].node_id       = node_id[i];
-         data_table[i].subgroup_id   = subgroup_id[i];
-         data_table[i].weight_id     = weight_id[i];
-         data_table[i].hold_out      = hold_out[i];
-         data_table[i].meas_value    = meas_value[i];
-         data_table[i].meas_std      = meas_std[i];
-         data_table[i].eta           = eta[i];
-         data_table[i].nu            = nu[i];
-         data_table[i].sample_size   = sample_size[i];
-         data_table[i].age_lower     = age_lower[i];
-         data_table[i].age_upper     = age_upper[i];
-         data_table[i].time_lower    = time_lower[i];
-         data_table[i].time_upper    = time_upper[i];
-      }
+   assert( data_table.size() == 0 );
+   data_table.resize(n_data);
+   for(size_t i = 0; i < n_data; i++)
+   {  data_table[i].integrand_id  = int_value[0 * n_data + i];
+      data_table[i].density_id    = int_value[1 * n_data + i];
+      data_table[i].node_id       = int_value[2 * n_data + i];
+      data_table[i].subgroup_id   = int_value[3 * n_data + i];
+      data_table[i].weight_id     = int_value[4 * n_data + i];
+      data_table[i].hold_out      = int_value[5 * n_data + i];
+      data_table[i].sample_size   = int_value[6 * n_data + i];
+      data_table[i].meas_value    = real_value[0 * n_data + i];
+      data_table[i].meas_std      = real_value[1 * n_data + i];
+      data_table[i].eta           = real_value[2 * n_data + i];
+      data_table[i].nu            = real_value[3 * n_data + i];
+      data_table[i].age_lower     = real_value[4 * n_data + i];
+      data_table[i].age_upper     = real_value[5 * n_data + i];
+      data_table[i].time_lower    = real_value[6 * n_data + i];
+      data_table[i].time_upper    = real_value[7 * n_data + i];
    }
-
-   // now get the covariates
+   //
+   // data_cov_value
    assert( data_cov_value.size() == 0 );
    data_cov_value.resize(n_data * n_covariate );
    for(size_t j = 0; j < n_covariate; j++)
-   {  std::stringstream ss;
-      ss << "x_" << j;
-      column_name = ss.str();
-      CppAD::vector<double> x_j;
-      get_table_column(db, table_name, column_name, x_j);
+   {  size_t offset = (n_real + j) * n_data;
       for(size_t i = 0; i < n_data; i++)
-         data_cov_value[ i * n_covariate + j ] = x_j[i];
+         data_cov_value[ i * n_covariate + j ] = real_value[offset + i];
    }
 
    // check for error conditions
@@ -70,6 +70,18 @@ include/dismod_at/get_db_input.hpp
 // END STRUCT
 }
 
+table_seconds
+=============
+For each input table *name* , ``table_seconds`` [ *name* ]
+is the elapsed wall clock time, in seconds,
+used to read and check that table.
+This can be used to determine which tables dominate the time
+between opening the database and being ready to run a command.
+These times are written to the log table when the
+:ref:`option_table@trace_db_input` option is true.
+
+Tables
+======
 Each *name* _ ``table`` above is defined by the corresponding
 ``get_`` *name* _ ``table`` routine.
 For example, ``age_table`` is the return value of
@@ -83,6 +95,7 @@ information.
 -----------------------------------------------------------------------------
 */
 # include <limits>
+# include <chrono>
 # include <dismod_at/configure.hpp>
 # include <dismod_at/min_max_vector.hpp>
 # include <dismod_at/get_db_input.hpp>
@@ -148,9 +161,22 @@ void get_db_input(sqlite3* db, db_input_struct& db_input)
    assert( db_input.data_table.size() == 0 );
    assert( db_input.avgint_table.size() == 0 );
    assert( db_input.weight_grid_table.size() == 0 );
+   assert( db_input.table_seconds.size() == 0 );
+   //
+   // table_seconds
+   // sets db_input.table_seconds[name] to the time since the previous call
+   typedef std::chrono::steady_clock clock;
+   clock::time_point previous = clock::now();
+   auto table_seconds = [&db_input, &previous](const std::string& name)
+   {  clock::time_point now = clock::now();
+      std::chrono::duration<double> seconds = now - previous;
+      db_input.table_seconds[name] = seconds.count();
+      previous = now;
+   };
    //
    // option table
    db_input.option_table      = get_option_table(db);
+   table_seconds("option");
    //
    // db_other
    sqlite3* db_other = DISMOD_AT_NULL_PTR;
@@ -177,26 +203,37 @@ void get_db_input(sqlite3* db, db_input_struct& db_input)
    //
    DISMOD_AT_SET_DB_TMP(age)
    db_input.age_table         = get_age_table(db_tmp);
+   table_seconds("age");
    DISMOD_AT_SET_DB_TMP(time)
    db_input.time_table        = get_time_table(db_tmp);
+   table_seconds("time");
    DISMOD_AT_SET_DB_TMP(rate)
    db_input.rate_table        = get_rate_table(db_tmp);
+   table_seconds("rate");
    DISMOD_AT_SET_DB_TMP(density)
    db_input.density_table     = get_density_table(db_tmp);
+   table_seconds("density");
    DISMOD_AT_SET_DB_TMP(weight)
    db_input.weight_table      = get_weight_table(db_tmp);
+   table_seconds("weight");
    DISMOD_AT_SET_DB_TMP(smooth)
    db_input.smooth_table      = get_smooth_table(db_tmp);
+   table_seconds("smooth");
    DISMOD_AT_SET_DB_TMP(covariate)
    db_input.covariate_table   = get_covariate_table(db_tmp);
+   table_seconds("covariate");
    DISMOD_AT_SET_DB_TMP(node)
    db_input.node_table        = get_node_table(db_tmp);
+   table_seconds("node");
    DISMOD_AT_SET_DB_TMP(nlist)
    db_input.nslist_table      = get_nslist_table(db_tmp);
+   table_seconds("nslist");
    DISMOD_AT_SET_DB_TMP(nlist_pair)
    db_input.nslist_pair_table = get_nslist_pair(db_tmp);
+   table_seconds("nslist_pair");
    DISMOD_AT_SET_DB_TMP(subgroup)
    db_input.subgroup_table    = get_subgroup_table(db_tmp);
+   table_seconds("subgroup");
    //
    // get_rate_eff_cov_table uses node_table and covariate_table
    // to check for errors
@@ -205,17 +242,20 @@ void get_db_input(sqlite3* db, db_input_struct& db_input)
       DISMOD_AT_SET_DB_TMP(rate_eff_cov)
       db_input.rate_eff_cov_table =
          get_rate_eff_cov_table(db_tmp, n_covariate, n_node);
+      table_seconds("rate_eff_cov");
    }
    //
    // get_mulcov_table uses subgroup table
    // to check for erros
    DISMOD_AT_SET_DB_TMP(mulcov)
    db_input.mulcov_table = get_mulcov_table(db_tmp, db_input.subgroup_table);
+   table_seconds("mulcov");
    //
    // get_prior_table uses density_table
    // to check for errors
    DISMOD_AT_SET_DB_TMP(prior)
    db_input.prior_table = get_prior_table(db_tmp, db_input.density_table);
+   table_seconds("prior");
    //
    // get_smooth_grid_table uses density_table and prior_table
    // to check for errors
@@ -223,6 +263,7 @@ void get_db_input(sqlite3* db, db_input_struct& db_input)
    db_input.smooth_grid_table = get_smooth_grid(
       db_tmp, db_input.density_table, db_input.prior_table
    );
+   table_seconds("smooth_grid");
    //
    // get_integrand_table uses mulcov_table and option_table
    // to check for errors
@@ -230,6 +271,7 @@ void get_db_input(sqlite3* db, db_input_struct& db_input)
    db_input.integrand_table  = get_integrand_table(
       db_tmp, db_input.mulcov_table, db_input.option_table
    );
+   table_seconds("integrand");
    //
    // get_data_table and get_avgint_table use this information
    // to check for errors
@@ -244,16 +286,19 @@ void get_db_input(sqlite3* db, db_input_struct& db_input)
       n_covariate, age_min, age_max, time_min, time_max,
       db_input.data_table, db_input.data_cov_value
    );
+   table_seconds("data");
    DISMOD_AT_SET_DB_TMP(avgint)
    get_avgint_table(
       db_tmp, n_covariate, age_min, age_max, time_min, time_max,
       db_input.avgint_table, db_input.avgint_cov_value
    );
+   table_seconds("avgint");
    // get_weight_grid_table checks if weight_id is in the data or avgint table.
    DISMOD_AT_SET_DB_TMP(weight)
    db_input.weight_grid_table = get_weight_grid(
       db_tmp, db_input.data_table, db_input.avgint_table
    );
+   table_seconds("weight_grid");
    //
    // -----------------------------------------------------------------------
    // check primary keys
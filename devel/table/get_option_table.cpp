@@ -142,7 +142,9 @@ CppAD::vector<option_struct> get_option_table(sqlite3* db)
       { "max_num_iter_random",              "100"                },
       { "meas_noise_effect",                "add_std_scale_all"  },
       { "method_random",                    "ipopt_random"       },
+      { "n_thread",                         "1"                  },
       { "ode_step_size",                    "10.0"               },
+      { "ode_tolerance",                    ""                   },
       { "other_database",                   ""                   },
       { "other_input_table",                ""                   },
       { "parent_node_id",                   ""                   },
@@ -152,9 +154,11 @@ CppAD::vector<option_struct> get_option_table(sqlite3* db)
       { "quasi_fixed",                      "true"               },
       { "random_seed",                      "0"                  },
       { "rate_case",                        "iota_pos_rho_zero"  },
+      { "save_fit_hes",                     "false"              },
       { "splitting_covariate",              ""                   },
       { "tolerance_fixed",                  "1e-8"               },
       { "tolerance_random",                 "1e-8"               },
+      { "trace_db_input",                   "false"              },
       { "trace_init_fit_model",             "false"              },
       { "warn_on_stderr",                   "true"               },
       { "zero_sum_child_rate",              ""                   },
@@ -284,6 +288,23 @@ CppAD::vector<option_struct> get_option_table(sqlite3* db)
             error_exit(msg, table_name, option_id);
          }
       }
+      // ode_tolerance
+      if( name_vec[match] == "ode_tolerance" )
+      {  bool ok = option_value[option_id] == "";
+         ok |= std::atof( option_value[option_id].c_str() ) > 0.0;
+         if( ! ok )
+         {  msg = "option_value is not empty and <= 0.0 for ode_tolerance";
+            error_exit(msg, table_name, option_id);
+         }
+      }
+      // n_thread
+      if( name_vec[match] == "n_thread" )
+      {  bool ok = std::atoi( option_value[option_id].c_str() ) > 0;
+         if( ! ok )
+         {  msg = "option_value is <= 0 for n_thread";
+            error_exit(msg, table_name, option_id);
+         }
+      }
       // random_seed
       if( name_vec[match] == "random_seed" )
       {  bool ok = std::atoi( option_value[option_id].c_str() ) >= 0;
@@ -312,6 +333,24 @@ CppAD::vector<option_struct> get_option_table(sqlite3* db)
             error_exit(msg, table_name, option_id);
          }
       }
+      // save_fit_hes
+      if( name_vec[match] == "save_fit_hes" )
+      {  if(
+            option_value[option_id] != "true" &&
+            option_value[option_id] != "false" )
+         {  msg = "option_value is not true or false";
+            error_exit(msg, table_name, option_id);
+         }
+      }
+      // trace_db_input
+      if( name_vec[match] == "trace_db_input" )
+      {  if(
+            option_value[option_id] != "true" &&
+            option_value[option_id] != "false" )
+         {  msg = "option_value is not true or false";
+            error_exit(msg, table_name, option_id);
+         }
+      }
       // trace_init_fit_model
       if( name_vec[match] == "trace_init_fit_model" )
       {  if(
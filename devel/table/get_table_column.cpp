@@ -13,6 +13,16 @@ Syntax
 
 | *column_type* = ``get_table_column_type`` ( *db* , *table_name* , *column_name* )
 | ``get_table_column`` ( *db* , *table_name* , *column_name* , *result* )
+| *n_row* = ``get_table_column`` ( *db* , *table_name* , *col_name* , *col_type* ,
+| |tab| *int_result* , *real_result* , *text_result*
+| )
+
+Purpose
+*******
+These routines use a prepared sqlite statement and get the values
+directly as ``int`` , ``double`` , or text;
+i.e., numerical values are not converted to text and back.
+The second syntax reads several columns in one pass through the table.
 
 db
 **
@@ -93,6 +103,70 @@ prototype
 If a real value is ``null`` , it is returned as the ``double``
 value ``nan`` .
 Note that it is not possible for a database value to be ``nan`` .
+
+Multiple Columns
+****************
+
+col_name
+========
+This argument has prototype
+
+   ``const CppAD::vector<std::string>&`` *col_name*
+
+and is the names of the columns we are getting information from.
+
+col_type
+========
+This argument has prototype
+
+   ``const CppAD::vector<std::string>&`` *col_type*
+
+It has the same size as *col_name* and *col_type* [ *j* ]
+is the type of the column with name *col_name* [ *j* ] .
+It is an error if this is not the type of the column in the database.
+
+n_row
+=====
+The return value has prototype
+
+   ``size_t`` *n_row*
+
+and is the number of rows in the table.
+
+int_result
+==========
+This argument has prototype
+
+   ``CppAD::vector<int>&`` *int_result*
+
+The input size of this vector must be zero.
+Upon return, the values in the *k*-th column (in *col_name* order)
+that has type ``integer`` are
+
+   *int_result* [ *k* * *n_row* + *i* ]
+
+for *i* = 0 , ... , *n_row* ``-1`` .
+They are ordered using the primary key and
+``null`` is represented as for the :ref:`get_table_column@result@integer`
+case above.
+
+real_result
+===========
+This argument has prototype
+
+   ``CppAD::vector<double>&`` *real_result*
+
+It is the same as *int_result* except that it contains the values
+for the columns that have type ``real`` .
+
+text_result
+===========
+This argument has prototype
+
+   ``CppAD::vector<std::string>&`` *text_result*
+
+It is the same as *int_result* except that it contains the values
+for the columns that have type ``text`` .
 {xrst_toc_hidden
    example/devel/table/get_table_column_xam.cpp
 }
@@ -104,6 +178,7 @@ this function.
 {xrst_end get_table_column}
 ------------------------------------------------------------------------------
 */
+# include <cstdlib>
 # include <limits>
 # include <string>
 # include <iostream>
@@ -117,16 +192,22 @@ this function.
 namespace {
    using std::string;
 
-   // Type specified by sqlite3_exec
-   typedef int (*callback_type)(void*, int, char**, char**);
-
-   // set by get_column, used by convert
+   // set by get_table_column, used by error messages
    string   table_name_;
    string   column_name_;
 
-   const char* convert(const std::string& not_used, char* v, size_t row_id)
-   {  if( v == DISMOD_AT_NULL_PTR )
+   // The convert functions get the value in column col_index of the
+   // current row of a prepared statement and convert it to the result type.
+   string convert(
+      const string&  not_used    ,
+      sqlite3_stmt*  p_stmt      ,
+      int            col_index   ,
+      size_t         row_id      )
+   {  if( sqlite3_column_type(p_stmt, col_index) == SQLITE_NULL )
          return "";
+      const char* v = reinterpret_cast<const char*>(
+         sqlite3_column_text(p_stmt, col_index)
+      );
       if( *v == '\0' )
       {  string msg = "The empty string appears in the text column ";
          msg += column_name_;
@@ -134,11 +215,15 @@ namespace {
       }
       return v;
    }
-   int    convert(const int& not_used, char* v, size_t row_id)
-   {  if(  v == DISMOD_AT_NULL_PTR )
+   int convert(
+      const int&     not_used    ,
+      sqlite3_stmt*  p_stmt      ,
+      int            col_index   ,
+      size_t         row_id      )
+   {  if( sqlite3_column_type(p_stmt, col_index) == SQLITE_NULL )
          return DISMOD_AT_NULL_INT;
       //
-      int value = std::atoi(v);
+      int value = sqlite3_column_int(p_stmt, col_index);
       //
       // no integer values should be the minimum integer
       if( value == DISMOD_AT_NULL_INT )
@@ -149,10 +234,24 @@ namespace {
       //
       return value;
    }
-   double convert(const double& not_used, char* v, size_t row_id)
-   {  if( v == DISMOD_AT_NULL_PTR )
+   double convert(
+      const double&  not_used    ,
+      sqlite3_stmt*  p_stmt      ,
+      int            col_index   ,
+      size_t         row_id      )
+   {  int type = sqlite3_column_type(p_stmt, col_index);
+      if( type == SQLITE_NULL )
          return std::numeric_limits<double>::quiet_NaN();
-      double value = std::atof(v);
+      double value;
+      if( type == SQLITE_TEXT )
+      {  // text in a real column; e.g., 'nan' or 'inf'
+         const char* v = reinterpret_cast<const char*>(
+            sqlite3_column_text(p_stmt, col_index)
+         );
+         value = std::atof(v);
+      }
+      else
+         value = sqlite3_column_double(p_stmt, col_index);
       if( value != value )
       {  string msg = "The value nan appears in the double column ";
          msg += column_name_;
@@ -161,53 +260,130 @@ namespace {
       return value;
    }
 
-   template <class Element>
-   int callback(void *result, int argc, char **argv, char **azColName)
-   {  typedef CppAD::vector<Element> vector;
-      assert( argc == 1 );
-      assert( result != DISMOD_AT_NULL_PTR );
-      vector* vector_result = static_cast<vector*>(result);
-      size_t row_id = vector_result->size();
-      vector_result->push_back( convert(Element(), argv[0], row_id ) );
-      return 0;
-   }
-   template int callback<std::string>(void*, int, char**, char**);
-
-   template <class Element>
-   void get_column(
+   // check that a column has the expected type
+   void check_column_type(
       sqlite3*                    db                    ,
       const std::string&          table_name            ,
       const std::string&          column_name           ,
-      CppAD::vector<Element>&     vector_result         )
-   {
-      // check that initial vector is empty
-      assert( vector_result.size() == 0 );
+      const std::string&          expected_type         )
+   {  std::string col_type = dismod_at::get_table_column_type(
+         db, table_name, column_name
+      );
+      if( col_type != expected_type )
+      {  size_t null_id = DISMOD_AT_NULL_SIZE_T;
+         std::string msg = "get_table_column for column = " + column_name;
+         msg += " in table " + table_name + ".\n";
+         if( col_type == "" )
+            msg += "Could not find table or column in table.";
+         else
+         {  msg += "Expected type to be " + expected_type;
+            msg += " not " + col_type;
+         }
+         dismod_at::error_exit(msg, table_name, null_id);
+      }
+   }
 
+   // Read the columns in col_name in one pass through the table.
+   // The k-th column with type integer (real, text) is placed in
+   // int_result (real_result, text_result) starting at index k * n_row.
+   // The return value is n_row.
+   size_t get_columns(
+      sqlite3*                            db             ,
+      const std::string&                  table_name     ,
+      const CppAD::vector<std::string>&   col_name       ,
+      const CppAD::vector<std::string>&   col_type       ,
+      CppAD::vector<int>&                 int_result     ,
+      CppAD::vector<double>&              real_result    ,
+      CppAD::vector<std::string>&         text_result    )
+   {  size_t n_col = col_name.size();
+      assert( col_type.size() == n_col );
+      //
+      // check that initial vectors are empty
+      assert( int_result.size() == 0 );
+      assert( real_result.size() == 0 );
+      assert( text_result.size() == 0 );
+      //
       // name of the primary key for this table
       std::string primary_key = table_name + "_id";
-
-      // sql command: select column_name from table_name
-      std::string cmd = "select ";
-      cmd            += column_name;
-      cmd            += " from ";
-      cmd            += table_name;
-      cmd            += " order by ";
-      cmd            += primary_key;
-
-      // execute sql command
-      char* zErrMsg     = DISMOD_AT_NULL_PTR;
-      callback_type fun = callback<Element>;
-      void* result      = static_cast<void*>(&vector_result);
-      int rc = sqlite3_exec(db, cmd.c_str(), fun, result, &zErrMsg);
-      if( rc )
-      {  assert(zErrMsg != DISMOD_AT_NULL_PTR );
-         std::string message = "SQL error: ";
+      //
+      // n_row
+      std::string cmd = "select count(*) from " + table_name;
+      std::string count = dismod_at::exec_sql_cmd(db, cmd, ',');
+      size_t n_row = size_t( std::atoi( count.c_str() ) );
+      //
+      // offset for each column in the corresponding result vector
+      CppAD::vector<size_t> offset(n_col);
+      size_t n_int  = 0;
+      size_t n_real = 0;
+      size_t n_text = 0;
+      for(size_t j = 0; j < n_col; ++j)
+      {  if( col_type[j] == "integer" )
+            offset[j] = n_row * n_int++;
+         else if( col_type[j] == "real" )
+            offset[j] = n_row * n_real++;
+         else
+         {  assert( col_type[j] == "text" );
+            offset[j] = n_row * n_text++;
+         }
+      }
+      int_result.resize(n_int * n_row);
+      real_result.resize(n_real * n_row);
+      text_result.resize(n_text * n_row);
+      //
+      // sql command: select col_name[0], ... from table_name
+      cmd = "select ";
+      for(size_t j = 0; j < n_col; ++j)
+      {  if( j > 0 )
+            cmd += ", ";
+         cmd += col_name[j];
+      }
+      cmd += " from " + table_name + " order by " + primary_key;
+      //
+      // prepare sqlite command
+      sqlite3_stmt* p_stmt;
+      int           n_byte = -1;
+      const char**  pz_tail = nullptr;
+      int rc = sqlite3_prepare_v2(db, cmd.c_str(), n_byte, &p_stmt, pz_tail);
+      if( rc != SQLITE_OK )
+      {  std::string message = "SQL error: ";
          message += sqlite3_errmsg(db);
          message += ". SQL command: " + cmd;
-         sqlite3_free(zErrMsg);
          dismod_at::error_exit(message);
       }
-      return;
+      //
+      // execute the command one row at a time
+      size_t row_id = 0;
+      rc = sqlite3_step(p_stmt);
+      while( rc == SQLITE_ROW && row_id < n_row )
+      {  for(size_t j = 0; j < n_col; ++j)
+         {  column_name_ = col_name[j];
+            int    col_index = int(j);
+            size_t index     = offset[j] + row_id;
+            if( col_type[j] == "integer" )
+               int_result[index] =
+                  convert(int(), p_stmt, col_index, row_id);
+            else if( col_type[j] == "real" )
+               real_result[index] =
+                  convert(double(), p_stmt, col_index, row_id);
+            else
+               text_result[index] =
+                  convert(std::string(), p_stmt, col_index, row_id);
+         }
+         ++row_id;
+         rc = sqlite3_step(p_stmt);
+      }
+      if( rc != SQLITE_DONE || row_id != n_row )
+      {  std::string message = "SQL error: ";
+         message += sqlite3_errmsg(db);
+         message += ". SQL command: " + cmd;
+         sqlite3_finalize(p_stmt);
+         dismod_at::error_exit(message);
+      }
+      //
+      // delete the statement
+      sqlite3_finalize(p_stmt);
+      //
+      return n_row;
    }
 }
 
@@ -267,30 +443,22 @@ void get_table_column(
    const std::string&          table_name          ,
    const std::string&          column_name         ,
    CppAD::vector<std::string>& text_result         )
-{  // for error message
-   size_t null_id = DISMOD_AT_NULL_SIZE_T;
-
-   // set globals used by error messages
+{  // set globals used by error messages
    table_name_ = table_name;
    column_name_ = column_name;
 
-   // check that initial vector is empty
-   assert( text_result.size() == 0 );
-
    // check the type for this column
-   std::string col_type = get_table_column_type(db, table_name, column_name);
-   if( col_type != "text" )
-   {  std::string msg = "get_table_column for column = " + column_name;
-      msg += " in table " + table_name + ".\n";
-      if( col_type == "" )
-         msg += "Could not find table or column in table.";
-      else
-         msg += "Expected type to be text not " + col_type;
-      error_exit(msg, table_name, null_id);
-   }
-
-   // Use template function for rest
-   get_column(db, table_name, column_name, text_result);
+   check_column_type(db, table_name, column_name, "text");
+
+   // read the column
+   CppAD::vector<std::string> col_name(1), col_type(1);
+   col_name[0] = column_name;
+   col_type[0] = "text";
+   CppAD::vector<int>    int_result;
+   CppAD::vector<double> real_result;
+   get_columns(
+      db, table_name, col_name, col_type, int_result, real_result, text_result
+   );
 
    return;
 }
@@ -300,30 +468,22 @@ void get_table_column(
    const std::string&          table_name         ,
    const std::string&          column_name        ,
    CppAD::vector<int>&         int_result         )
-{  // for error message
-   size_t null_id = DISMOD_AT_NULL_SIZE_T;
-
-   // set globals used by error messages
+{  // set globals used by error messages
    table_name_ = table_name;
    column_name_ = column_name;
 
-   // check that initial vector is empty
-   assert( int_result.size() == 0 );
-
    // check the type for this column
-   std::string col_type = get_table_column_type(db, table_name, column_name);
-   if( col_type != "integer" )
-   {  std::string msg = "get_table_column for column = " + column_name;
-      msg += " in table " + table_name + ".\n";
-      if( col_type == "" )
-         msg += "Could not find table or column in table.";
-      else
-         msg += "Expected type to be integer not " + col_type;
-      error_exit(msg, table_name, null_id);
-   }
-
-   // Use template function for rest
-   get_column(db, table_name, column_name, int_result);
+   check_column_type(db, table_name, column_name, "integer");
+
+   // read the column
+   CppAD::vector<std::string> col_name(1), col_type(1);
+   col_name[0] = column_name;
+   col_type[0] = "integer";
+   CppAD::vector<double>      real_result;
+   CppAD::vector<std::string> text_result;
+   get_columns(
+      db, table_name, col_name, col_type, int_result, real_result, text_result
+   );
 
    return;
 }
@@ -333,32 +493,48 @@ void get_table_column(
    const std::string&          table_name         ,
    const std::string&          column_name        ,
    CppAD::vector<double>&      double_result      )
-{  // for error message
-   size_t null_id = DISMOD_AT_NULL_SIZE_T;
-
-   // set globals used by error messages
+{  // set globals used by error messages
    table_name_ = table_name;
    column_name_ = column_name;
 
-   // check that initial vector is empty
-   assert( double_result.size() == 0 );
-
    // check the type for this column
-   std::string col_type = get_table_column_type(db, table_name, column_name);
-   if( col_type != "real" )
-   {  std::string msg = "get_table_column for column = " + column_name;
-      msg += " in table " + table_name + ".\n";
-      if( col_type == "" )
-         msg += "Could not find table or column in table.";
-      else
-         msg += "Expected type to be real not " + col_type;
-      error_exit(msg, table_name, null_id);
-   }
-
-   // Use template function for rest
-   get_column(db, table_name, column_name, double_result);
+   check_column_type(db, table_name, column_name, "real");
+
+   // read the column
+   CppAD::vector<std::string> col_name(1), col_type(1);
+   col_name[0] = column_name;
+   col_type[0] = "real";
+   CppAD::vector<int>         int_result;
+   CppAD::vector<std::string> text_result;
+   get_columns(
+      db, table_name, col_name, col_type, int_result, double_result, text_result
+   );
 
    return;
 }
 
+size_t get_table_column(
+   sqlite3*                            db             ,
+   const std::string&                  table_name     ,
+   const CppAD::vector<std::string>&   col_name       ,
+   const CppAD::vector<std::string>&   col_type       ,
+   CppAD::vector<int>&                 int_result     ,
+   CppAD::vector<double>&              real_result    ,
+   CppAD::vector<std::string>&         text_result    )
+{  // set globals used by error messages
+   table_name_ = table_name;
+   //
+   // check the type for each column
+   for(size_t j = 0; j < col_name.size(); ++j)
+   {  column_name_ = col_name[j];
+      check_column_type(db, table_name, col_name[j], col_type[j]);
+   }
+   //
+   // read the columns
+   size_t n_row = get_columns(
+      db, table_name, col_name, col_type, int_result, real_result, text_result
+   );
+   return n_row;
+}
+
 } // END DISMOD_AT_NAMESPACE
@@ -0,0 +1,295 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-23 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin table_writer dev}
+
+Write a Database Table One Row at a Time
+########################################
+
+Syntax
+******
+
+| ``dismod_at::table_writer`` *writer* (
+| |tab| *db* , *table_name* , *col_name* , *col_type* , *col_unique* , *n_commit*
+| )
+| *writer* . ``set_integer`` ( *col_index* , *int_value* )
+| *writer* . ``set_real`` ( *col_index* , *real_value* )
+| *writer* . ``set_text`` ( *col_index* , *text_value* )
+| *writer* . ``set_null`` ( *col_index* )
+| *writer* . ``next_row`` ()
+| *n_row* = *writer* . ``n_row`` ()
+| *writer* . ``close`` ()
+
+Prototype
+*********
+{xrst_literal
+   include/dismod_at/table_writer.hpp
+   // BEGIN_TABLE_WRITER_PROTOTYPE
+   // END_TABLE_WRITER_PROTOTYPE
+}
+
+Purpose
+*******
+Create a table and write its rows one at a time.
+In contrast to :ref:`cpp_create_table-name` , the entire table
+does not need to be stored in memory (as strings) before it is written.
+The values are bound to a prepared ``insert`` statement
+(instead of being converted to text and parsed by sqlite)
+and the rows are written inside transactions that contain
+*n_commit* rows each.
+
+db
+**
+is the database we are placing the table into.
+
+table_name
+**********
+is the name of the table we are creating.
+It must not already exist in *db* .
+
+col_name
+********
+is a vector of the names for the columns in this table
+(not including the primary key column).
+The size of this vector must greater than zero.
+
+col_type
+********
+It has the same size and order as *col_name* and specifies
+the type for the corresponding columns.
+The valid types are ``text`` , ``integer`` , and ``real`` .
+
+col_unique
+**********
+It has the same size and order as *col_name* and specifies
+if the corresponding columns have a
+``unique`` constraint (no repeated values).
+
+n_commit
+********
+This is the number of rows between transaction commits
+and must be greater than zero.
+Larger values use fewer transactions (which is faster)
+but keep more rows in the sqlite journal.
+
+col_index
+*********
+This is the index in *col_name* for the column that is being set
+in the current row.
+
+set_integer
+***********
+Sets the value of the specified column in the current row to *int_value* .
+The corresponding *col_type* must be ``integer`` .
+
+set_real
+********
+Sets the value of the specified column in the current row to *real_value* .
+The corresponding *col_type* must be ``real`` .
+If *real_value* is nan, the value in the table will be null.
+
+set_text
+********
+Sets the value of the specified column in the current row to *text_value* .
+The corresponding *col_type* must be ``text`` .
+
+set_null
+********
+Sets the value of the specified column in the current row to null.
+
+next_row
+********
+Writes the current row to the table.
+All of the columns must be set before each call to ``next_row`` .
+
+table_name_id
+=============
+A column with name *table_name* _ ``id`` and type
+``integer primary key`` is included as the first column in the table.
+Its values start with zero (for the first row) and
+increment by one for each row.
+
+n_row
+*****
+is the number of rows that have been written to the table.
+
+close
+*****
+Commits the rows that have not yet been committed and frees the
+prepared statement.
+No other member function, except ``n_row`` , can be called after ``close`` .
+If ``close`` has not been called when *writer* is destroyed,
+it is called by the destructor.
+The ``close`` function must be called before the program exits
+(e.g., before calling ``error_exit`` ) otherwise the rows
+since the last commit will not be in the table.
+{xrst_toc_hidden
+   example/devel/table/table_writer_xam.cpp
+}
+Example
+*******
+The file :ref:`table_writer_xam.cpp-name` is an example use of
+``table_writer`` .
+
+{xrst_end table_writer}
+---------------------------------------------------------------------------
+*/
+# include <cassert>
+# include <dismod_at/table_writer.hpp>
+# include <dismod_at/exec_sql_cmd.hpp>
+# include <dismod_at/error_exit.hpp>
+# include <dismod_at/configure.hpp>
+
+namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
+
+// fail
+void table_writer::fail(const std::string& message)
+{  if( p_stmt_ != DISMOD_AT_NULL_PTR )
+   {  sqlite3_finalize(p_stmt_);
+      p_stmt_ = DISMOD_AT_NULL_PTR;
+      // so the error message is not rolled back with the table rows
+      exec_sql_cmd(db_, "rollback");
+   }
+   error_exit(message, table_name_);
+}
+
+// ctor
+table_writer::table_writer(
+   sqlite3*                            db             ,
+   const std::string&                  table_name     ,
+   const CppAD::vector<std::string>&   col_name       ,
+   const CppAD::vector<std::string>&   col_type       ,
+   const CppAD::vector<bool>&          col_unique     ,
+   size_t                              n_commit       )
+: db_(db)
+, table_name_(table_name)
+, col_type_(col_type)
+, n_commit_(n_commit)
+, p_stmt_(DISMOD_AT_NULL_PTR)
+, n_row_(0)
+, n_pending_(0)
+{  size_t n_col = col_name.size();
+   assert( n_col > 0 );
+   assert( col_type.size() == n_col );
+   assert( col_unique.size() == n_col );
+   assert( n_commit > 0 );
+   //
+   // create the table
+   std::string cmd = "create table " + table_name;
+   cmd += " (" + table_name + "_id integer primary key";
+   for(size_t j = 0; j < n_col; j++)
+   {  cmd += ", " + col_name[j] + " " + col_type[j];
+      if( col_unique[j] )
+         cmd += " unique";
+   }
+   cmd += ");";
+   exec_sql_cmd(db, cmd);
+   //
+   // prepare the insert command
+   cmd  = "insert into " + table_name;
+   cmd += " (" + table_name + "_id";
+   for(size_t j = 0; j < n_col; j++)
+      cmd += ", " + col_name[j];
+   cmd += ") values(?";
+   for(size_t j = 0; j < n_col; j++)
+      cmd += ",?";
+   cmd += ")";
+   int           n_byte  = -1;
+   const char**  pz_tail = nullptr;
+   int rc = sqlite3_prepare_v2(db, cmd.c_str(), n_byte, &p_stmt_, pz_tail);
+   if( rc != SQLITE_OK )
+   {  std::string message = "table_writer: following command failed:\n";
+      message            += cmd;
+      p_stmt_             = DISMOD_AT_NULL_PTR;
+      error_exit(message);
+   }
+   //
+   // start the first transaction
+   exec_sql_cmd(db, "begin");
+}
+
+// destructor
+table_writer::~table_writer(void)
+{  if( p_stmt_ != DISMOD_AT_NULL_PTR )
+      close();
+}
+
+// set_integer
+void table_writer::set_integer(size_t col_index, int value)
+{  assert( p_stmt_ != DISMOD_AT_NULL_PTR );
+   assert( col_type_[col_index] == "integer" );
+   int value_index = int(col_index) + 2;
+   sqlite3_bind_int(p_stmt_, value_index, value);
+}
+
+// set_real
+void table_writer::set_real(size_t col_index, double value)
+{  assert( p_stmt_ != DISMOD_AT_NULL_PTR );
+   assert( col_type_[col_index] == "real" );
+   int value_index = int(col_index) + 2;
+   sqlite3_bind_double(p_stmt_, value_index, value);
+}
+
+// set_text
+void table_writer::set_text(size_t col_index, const std::string& value)
+{  assert( p_stmt_ != DISMOD_AT_NULL_PTR );
+   assert( col_type_[col_index] == "text" );
+   int value_index = int(col_index) + 2;
+   int n_byte      = int( value.size() );
+   sqlite3_bind_text(
+      p_stmt_, value_index, value.c_str(), n_byte, SQLITE_TRANSIENT
+   );
+}
+
+// set_null
+void table_writer::set_null(size_t col_index)
+{  assert( p_stmt_ != DISMOD_AT_NULL_PTR );
+   int value_index = int(col_index) + 2;
+   sqlite3_bind_null(p_stmt_, value_index);
+}
+
+// next_row
+void table_writer::next_row(void)
+{  assert( p_stmt_ != DISMOD_AT_NULL_PTR );
+   //
+   // primary key
+   sqlite3_bind_int64(p_stmt_, 1, sqlite3_int64(n_row_) );
+   //
+   // execute the statement
+   int rc = sqlite3_step(p_stmt_);
+   if( rc != SQLITE_DONE )
+   {  std::string message = "table_writer: inserting row in ";
+      message            += table_name_ + " failed: ";
+      message            += sqlite3_errmsg(db_);
+      fail(message);
+   }
+   //
+   // prepare for the next row
+   sqlite3_reset(p_stmt_);
+   sqlite3_clear_bindings(p_stmt_);
+   ++n_row_;
+   ++n_pending_;
+   //
+   // commit and start a new transaction
+   if( n_pending_ == n_commit_ )
+   {  exec_sql_cmd(db_, "commit");
+      exec_sql_cmd(db_, "begin");
+      n_pending_ = 0;
+   }
+}
+
+// n_row
+size_t table_writer::n_row(void) const
+{  return n_row_; }
+
+// close
+void table_writer::close(void)
+{  assert( p_stmt_ != DISMOD_AT_NULL_PTR );
+   sqlite3_finalize(p_stmt_);
+   p_stmt_ = DISMOD_AT_NULL_PTR;
+   exec_sql_cmd(db_, "commit");
+}
+
+} // END_DISMOD_AT_NAMESPACE
@@ -15,7 +15,8 @@ Syntax
 | *n_child* = *child_object* . ``child_size`` ()
 | *node_id* = *child_object* . ``child_id2node_id`` ( *child_id* )
 
-*child* = *child_object* . ``table_id2child`` ( *table_id* )
+| *child* = *child_object* . ``table_id2child`` ( *table_id* )
+| *child* = *child_object* . ``node_id2child`` ( *node_id* )
 
 child_object
 ************
@@ -128,6 +129,18 @@ If *child* == *n_child* +1 ,
    *table* [ *table_id* ]. ``node_id``
 
 is not the parent node and not a descendant of the parent node.
+
+node_id2child
+*************
+This returns the :ref:`child_info@table_id2child@child` value
+corresponding to a *node_id* (instead of a *table_id* ); i.e.,
+
+   *child_object* . ``table_id2child`` ( *table_id* ) ==
+   *child_object* . ``node_id2child`` ( *table* [ *table_id* ]. ``node_id`` )
+
+The constructor computes this value for every node in the
+*node_table* with work proportional to the number of nodes.
+Hence both ``table_id2child`` and ``node_id2child`` are order one.
 {xrst_toc_hidden
    example/devel/utility/child_info_xam.cpp
 }
@@ -160,38 +173,56 @@ child_info::child_info(
          child_id2node_id_.push_back(node_id);
    }
 
-   // table_id2child_id
+   // node_id2child_
+   // Each node is visited a bounded number of times, so the total work is
+   // proportional to the number of nodes (not nodes times tree depth).
+   size_t n_node  = node_table.size();
+   size_t n_child = child_id2node_id_.size();
+   size_t unknown = DISMOD_AT_NULL_SIZE_T;
+   size_t on_path = n_child + 2;
+   node_id2child_.resize(n_node);
+   for(size_t node_id = 0; node_id < n_node; ++node_id)
+      node_id2child_[node_id] = unknown;
+   if( parent_node_id < n_node )
+      node_id2child_[parent_node_id] = n_child;
+   for(size_t child = 0; child < n_child; ++child)
+      node_id2child_[ child_id2node_id_[child] ] = child;
+   //
+   // path: nodes between the current node and its first known ancestor
+   CppAD::vector<size_t> path;
+   for(size_t start = 0; start < n_node; ++start)
+   {  size_t node_id = start;
+      path.resize(0);
+      while( node_id != DISMOD_AT_NULL_SIZE_T
+         && node_id2child_[node_id] == unknown )
+      {  assert( node_id < n_node );
+         node_id2child_[node_id] = on_path;
+         path.push_back(node_id);
+         node_id = size_t( node_table[node_id].parent );
+      }
+      // child index for every node on the path
+      size_t child;
+      if( node_id == DISMOD_AT_NULL_SIZE_T )
+         child = n_child + 1;
+      else if( node_id2child_[node_id] == on_path )
+      {  // following parents from start leads back to node_id
+         std::string msg = "This node is a descendant of itself";
+         error_exit(msg, "node", node_id);
+         child = n_child + 1; // not reached
+      }
+      else
+         child = node_id2child_[node_id];
+      for(size_t i = 0; i < path.size(); ++i)
+         node_id2child_[ path[i] ] = child;
+   }
+
+   // table_id2child_
    size_t n_table = table.size();
    table_id2child_.resize(n_table);
    for(size_t table_id = 0; table_id < n_table; table_id++)
    {  size_t node_id = size_t( table[table_id].node_id );
-      // check if this is the parent node
-      bool   found   = parent_node_id == node_id;
-      // special child index for the parent node
-      size_t child   = child_id2node_id_.size();
-      // loop to check child nodes
-      bool   more    = ! found;
-      while(more)
-      {  for(size_t i = 0; i < child_id2node_id_.size(); i++)
-         {  if( child_id2node_id_[i] == node_id )
-            {  child = i;
-               found = true;
-            }
-         }
-         more = (! found) && (node_id != DISMOD_AT_NULL_SIZE_T);
-         if( more )
-         {  size_t parent = size_t ( node_table[node_id].parent );
-            if( parent == node_id )
-            {  // infinite loop checking if parent_node_id is an ancestor
-               std::string msg = "This node is a descendant of itself";
-               error_exit(msg, "node", node_id);
-            }
-            node_id = parent;
-         }
-      }
-      if( ! found )
-         child = child_id2node_id_.size() + 1;
-      table_id2child_[table_id] = child;
+      assert( node_id < n_node );
+      table_id2child_[table_id] = node_id2child_[node_id];
    }
 }
 
@@ -204,6 +235,9 @@ size_t child_info::child_id2node_id(size_t child_id) const
 size_t child_info::table_id2child(size_t table_id) const
 {  return table_id2child_[table_id]; }
 
+size_t child_info::node_id2child(size_t node_id) const
+{  return node_id2child_[node_id]; }
+
 
 // instantiate child_info constructor for two possible cases
 template child_info::child_info(
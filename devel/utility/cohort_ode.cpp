@@ -12,15 +12,23 @@ Syntax
 ******
 
 | ``cohort_ode`` (
-| *rate_case* , *age* , *pini* , *iota* , *rho* , *chi* , *omega* , *s_out* , *c_out*
+| *rate_case* , *ode_tolerance* , *age* , *pini* , *iota* , *rho* , *chi* , *omega* , *s_out* , *c_out*
+| )
+| *case_number* = ``cohort_ode_case_number`` ( *rate_case* )
+| ``cohort_ode`` (
+| *case_number* , *ode_tolerance* , *age* , *pini* , *iota* , *rho* , *chi* , *omega* , *s_out* , *c_out*
 | )
 
 Prototype
 *********
 {xrst_literal
+   // BEGIN_CASE_NUMBER_PROTOTYPE
+   // END_CASE_NUMBER_PROTOTYPE
    // BEGIN_PROTOTYPE
    // END_PROTOTYPE
 }
+The *rate_case* version of ``cohort_ode`` has the same prototype
+with *case_number* replaced by ``const std::string&`` *rate_case* .
 
 Purpose
 *******
@@ -46,6 +54,53 @@ This is the value of
 :ref:`option_table@rate_case` in the option table
 and cannot be ``no_ode`` .
 
+case_number
+***********
+This is zero if *rate_case* is ``trapezoidal`` and otherwise it is the
+:ref:`eigen_ode2@case_number` corresponding to *rate_case* .
+If *rate_case* is ``no_ode`` ,
+``cohort_ode_case_number`` returns ``DISMOD_AT_NULL_SIZE_T`` .
+Converting *rate_case* once, and using the *case_number* version of
+``cohort_ode`` , avoids string comparisons for each cohort.
+The case is chosen once per call and the corresponding solver
+is a separate instantiation; i.e.,
+there is no case selection in the loop over age intervals
+and the rates that are zero for this case
+(iota for ``iota_zero`` , rho for ``rho_zero`` )
+are not used.
+
+ode_tolerance
+*************
+This is the value of :ref:`option_table@ode_tolerance`
+in the option table (zero if it is empty).
+If *Float* is ``a1_double`` , *ode_tolerance* must be zero.
+If *ode_tolerance* is zero, or *rate_case* is ``trapezoidal`` ,
+one step is used for each age interval.
+Otherwise, for each age interval,
+the rates are interpolated linearly between the values at the ends of
+the interval and the solution *y1* using one :ref:`eigen_ode2-name` step,
+with the rates at the middle of the interval,
+is compared with the solution *y2* using two steps,
+with the rates at the middle of each half of the interval.
+If the rates are constant, *y1* and *y2* are equal.
+Otherwise, the error in *y1* is proportional to the cube of the
+interval length and is estimated by
+
+   *err* = (4/3) ``max`` ( | *y1* ``-`` *y2* | )
+
+If *err* is greater than *ode_tolerance* , the interval is split into
+
+   *n_sub* = ``ceil`` ( ( *err* / *ode_tolerance* )^(1/2) )
+
+equal sub-intervals (but not more than 100).
+The square root is used because the sum of the errors for the
+*n_sub* steps is proportional to *err* / *n_sub* ^2 .
+
+a1_double
+*********
+If *Float* is ``a1_double`` , each step is recorded as one
+:ref:`ode2_chkpoint-name` operation.
+
 age
 ***
 This vector has size *n_cohort* and
@@ -93,17 +148,207 @@ It returns true for success and false for failure.
 
 {xrst_end cohort_ode}
 */
+# include <cmath>
+# include <algorithm>
+# include <type_traits>
 # include <dismod_at/cohort_ode.hpp>
 # include <dismod_at/eigen_ode2.hpp>
 # include <dismod_at/trap_ode2.hpp>
+# include <dismod_at/ode2_chkpoint.hpp>
 # include <dismod_at/a1_double.hpp>
+# include <dismod_at/null_int.hpp>
+
+namespace { // BEGIN_EMPTY_NAMESPACE
+   //
+   // maximum number of sub-intervals for one age interval
+   const size_t max_n_sub_ = 100;
+   //
+   // rate_mid
+   // value of a rate in the middle of the j-th of n_sub equal sub-intervals
+   // of the age interval from age[k-1] to age[k]
+   template <class Float>
+   Float rate_mid(
+      const CppAD::vector<Float>& rate, size_t k, size_t j, size_t n_sub
+   )
+   {  if( n_sub == 1 )
+         return (rate[k-1] + rate[k]) / Float(2);
+      double w_p = (double(j) + 0.5) / double(n_sub);
+      double w_m = 1.0 - w_p;
+      return w_m * rate[k-1] + w_p * rate[k];
+   }
+   //
+   // set_b
+   // matrix in the ODE for the j-th of n_sub sub-intervals of the k-th
+   // age interval. Rates that are zero for this case_number are not used.
+   template <size_t case_number, class Float>
+   void set_b(
+      size_t                       k           ,
+      size_t                       j           ,
+      size_t                       n_sub       ,
+      const CppAD::vector<Float>&  iota        ,
+      const CppAD::vector<Float>&  rho         ,
+      const CppAD::vector<Float>&  chi         ,
+      const CppAD::vector<Float>&  omega       ,
+      CppAD::vector<Float>&        b           )
+   {  constexpr bool iota_zero = case_number == 1 || case_number == 2;
+      constexpr bool rho_zero  = case_number == 1 || case_number == 3;
+      //
+      Float chi_m   = rate_mid(chi,   k, j, n_sub);
+      Float omega_m = rate_mid(omega, k, j, n_sub);
+      if constexpr( iota_zero )
+      {  b[0] = - omega_m;
+         b[2] = Float(0);
+      }
+      else
+      {  Float iota_m = rate_mid(iota, k, j, n_sub);
+         b[0] = - (iota_m + omega_m);
+         b[2] = + iota_m;
+      }
+      if constexpr( rho_zero )
+      {  b[1] = Float(0);
+         b[3] = - (chi_m + omega_m);
+      }
+      else
+      {  Float rho_m = rate_mid(rho, k, j, n_sub);
+         b[1] = + rho_m;
+         b[3] = - (rho_m + chi_m + omega_m);
+      }
+   }
+   //
+   // ode_step
+   template <size_t case_number, class Float>
+   CppAD::vector<Float> ode_step(
+      const CppAD::vector<Float>&  b           ,
+      const CppAD::vector<Float>&  yi          ,
+      const Float&                 tf          )
+   {  // a1_double: record one checkpoint operation for the step
+      if constexpr( std::is_same<Float, dismod_at::a1_double>::value )
+         return dismod_at::ode2_chkpoint(case_number, b, yi, tf);
+      else if constexpr( case_number == 0 )
+         return dismod_at::trap_ode2(b, yi, tf);
+      else
+         return dismod_at::eigen_ode2<case_number, Float>(b, yi, tf);
+   }
+   //
+   // case_cohort_ode
+   // cohort_ode with the case_number known at compile time
+   template <size_t case_number, class Float>
+   void case_cohort_ode(
+      double                       ode_tolerance ,
+      const CppAD::vector<double>& age       ,
+      const Float&                 pini      ,
+      const CppAD::vector<Float>&  iota      ,
+      const CppAD::vector<Float>&  rho       ,
+      const CppAD::vector<Float>&  chi       ,
+      const CppAD::vector<Float>&  omega     ,
+      CppAD::vector<Float>&        s_out     ,
+      CppAD::vector<Float>&        c_out     )
+   {  size_t n_cohort = age.size();
+      //
+      // initialize for first interval
+      c_out[0] = pini;
+      s_out[0] = Float(1) - pini;
+      //
+      CppAD::vector<Float> b(4), yi(2), yf(2), yh(2);
+      Float tf;
+      //
+      // the split of an interval depends on the rates, so it is only
+      // done for double; see ode_tolerance in the documentation above
+      constexpr bool is_double = std::is_same<Float, double>::value;
+      assert( is_double || ode_tolerance == 0.0 );
+      bool adaptive = is_double && ode_tolerance > 0.0 && case_number != 0;
+      for(size_t k = 1; k < n_cohort; ++k)
+      {  // integrate from age[k-1] to age[k]
+         //
+         // arguments to eigen_ode2 using rates at the midpoint
+         set_b<case_number>(k, 0, 1, iota, rho, chi, omega, b);
+         yi[0] = s_out[k-1];
+         yi[1] = c_out[k-1];
+         tf    = age[k] - age[k-1];
+         //
+         // one step in solving ODE for this cohort
+         yf = ode_step<case_number>(b, yi, tf);
+         //
+         // n_sub: number of sub-intervals for this age interval
+         size_t n_sub = 1;
+         if constexpr( is_double )
+         {  if( adaptive )
+            {  // yh: two steps using the rates at the middle of each half
+               Float th = tf / 2.0;
+               yh = yi;
+               for(size_t j = 0; j < 2; ++j)
+               {  set_b<case_number>(k, j, 2, iota, rho, chi, omega, b);
+                  yh = ode_step<case_number>(b, yh, th);
+               }
+               // err: estimate of the error in the one step solution yf
+               double err = 0.0;
+               for(size_t i = 0; i < 2; ++i)
+                  err = std::max(err, 4.0 * std::fabs(yf[i] - yh[i]) / 3.0 );
+               if( err > ode_tolerance )
+               {  double ratio = std::sqrt( err / ode_tolerance );
+                  n_sub = std::min( max_n_sub_, size_t( std::ceil(ratio) ) );
+               }
+            }
+         }
+         if( n_sub == 2 )
+            yf = yh;
+         else if( n_sub > 2 )
+         {  // solve using n_sub steps with rates interpolated from the
+            // end points of this age interval
+            tf = (age[k] - age[k-1]) / double(n_sub);
+            for(size_t j = 0; j < n_sub; ++j)
+            {  set_b<case_number>(k, j, n_sub, iota, rho, chi, omega, b);
+               yf = ode_step<case_number>(b, yi, tf);
+               yi = yf;
+            }
+         }
+         //
+         // copy result to output vector
+         s_out[k] = yf[0];
+         c_out[k] = yf[1];
+      }
+      return;
+   }
+} // END_EMPTY_NAMESPACE
 
 namespace dismod_at { // BEGIN DISMOD_AT_NAMESPACE
 
+// BEGIN_CASE_NUMBER_PROTOTYPE
+size_t cohort_ode_case_number(const std::string& rate_case)
+// END_CASE_NUMBER_PROTOTYPE
+{  /*
+   b[0] = - ( iota + omega )
+   b[1] = + rho
+   b[2] = + iota
+   b[3] = - ( rho + chi + omega );
+   */
+   if( rate_case == "trapezoidal" )
+      return 0;
+   if( rate_case == "iota_zero_rho_zero" )
+   {  // b[1] = 0, b[2] = 0
+      return 1;
+   }
+   if( rate_case == "iota_zero_rho_pos" )
+   {  // b[1] != 0, b[2] = 0
+      return 2;
+   }
+   if( rate_case == "iota_pos_rho_zero" )
+   {  // b[1] = 0, b[2] != 0
+      return 3;
+   }
+   if( rate_case == "iota_pos_rho_pos" )
+   {  // b[1] != 0, b[2] != 0
+      return 4;
+   }
+   assert( rate_case == "no_ode" );
+   return DISMOD_AT_NULL_SIZE_T;
+}
+
 // BEGIN_PROTOTYPE
 template <class Float>
 void cohort_ode(
-   const std::string&           rate_case ,
+   size_t                       case_number ,
+   double                       ode_tolerance ,
    const CppAD::vector<double>& age       ,
    const Float&                 pini      ,
    const CppAD::vector<Float>&  iota      ,
@@ -120,76 +365,79 @@ void cohort_ode(
    assert( n_cohort == omega.size() );
    assert( n_cohort == s_out.size() );
    assert( n_cohort == c_out.size() );
-   assert( rate_case != "no_ode" );
-   /*
-   -------------------------------------------------------------------------
-   case_number
-   -------------------------------------------------------------------------
-   b[0] = - ( iota + omega )
-   b[1] = + rho
-   b[2] = + iota
-   b[3] = - ( rho + chi + omega );
-   */
-   size_t case_number = 0;
-   if( rate_case == "iota_zero_rho_zero" )
-   {  // b[1] = 0, b[2] = 0
-      case_number = 1;
-   }
-   else if( rate_case == "iota_zero_rho_pos" )
-   {  // b[1] != 0, b[2] = 0
-      case_number = 2;
-   }
-   else if( rate_case == "iota_pos_rho_zero" )
-   {  // b[1] = 0, b[2] != 0
-      case_number = 3;
-   }
-   else if( rate_case == "iota_pos_rho_pos" )
-   {  // b[1] != 0, b[2] != 0
-      case_number = 4;
-   }
-   assert( rate_case == "trapezoidal" || case_number != 0 );
-   // ----------------------------------------------------------------------
-   // initialize for first interval
-   c_out[0] = pini;
-   s_out[0] = Float(1) - pini;
+   assert( case_number <= 4 );
    //
-   CppAD::vector<Float> b(4), yi(2), yf(2);
-   Float tf;
-   for(size_t k = 1; k < n_cohort; ++k)
-   {  // integrate from age[k-1] to age[k]
-      //
-      // rates at the midpoint
-      Float iota_m   = (iota[k-1]   + iota[k])  / Float(2);
-      Float rho_m    = (rho[k-1]    + rho[k])   / Float(2);
-      Float chi_m    = (chi[k-1]    + chi[k])   / Float(2);
-      Float omega_m  = (omega[k-1]  + omega[k]) / Float(2);
-      //
-      // arguments to eigen_ode2
-      b[0]  = - (iota_m + omega_m);
-      b[1]  = + rho_m;
-      b[2]  = + iota_m;
-      b[3]  = - (rho_m + chi_m + omega_m);
-      yi[0] = s_out[k-1];
-      yi[1] = c_out[k-1];
-      tf    = age[k] - age[k-1];
-      //
-      // one step in solving ODE for this cohort
-      if( case_number == 0 )
-         yf = trap_ode2(b, yi, tf);
-      else
-         yf = eigen_ode2(case_number, b, yi, tf);
-      //
-      // copy result to output vector
-      s_out[k] = yf[0];
-      c_out[k] = yf[1];
+   // dispatch once per cohort to the version for this case_number
+   switch( case_number )
+   {  case 0:
+      case_cohort_ode<0>(
+         ode_tolerance, age, pini, iota, rho, chi, omega, s_out, c_out
+      );
+      break;
+
+      case 1:
+      case_cohort_ode<1>(
+         ode_tolerance, age, pini, iota, rho, chi, omega, s_out, c_out
+      );
+      break;
+
+      case 2:
+      case_cohort_ode<2>(
+         ode_tolerance, age, pini, iota, rho, chi, omega, s_out, c_out
+      );
+      break;
+
+      case 3:
+      case_cohort_ode<3>(
+         ode_tolerance, age, pini, iota, rho, chi, omega, s_out, c_out
+      );
+      break;
+
+      default:
+      case_cohort_ode<4>(
+         ode_tolerance, age, pini, iota, rho, chi, omega, s_out, c_out
+      );
+      break;
    }
    return;
 }
+template <class Float>
+void cohort_ode(
+   const std::string&           rate_case ,
+   double                       ode_tolerance ,
+   const CppAD::vector<double>& age       ,
+   const Float&                 pini      ,
+   const CppAD::vector<Float>&  iota      ,
+   const CppAD::vector<Float>&  rho       ,
+   const CppAD::vector<Float>&  chi       ,
+   const CppAD::vector<Float>&  omega     ,
+   CppAD::vector<Float>&        s_out     ,
+   CppAD::vector<Float>&        c_out     )
+{  assert( rate_case != "no_ode" );
+   size_t case_number = cohort_ode_case_number(rate_case);
+   cohort_ode(
+      case_number, ode_tolerance,
+      age, pini, iota, rho, chi, omega, s_out, c_out
+   );
+}
 
 // instantiation macro
 # define DISMOT_AT_INSTANTIATE_COHORT_ODE(Float)     \
+   template void cohort_ode<Float>(                 \
+   size_t                       case_number     ,   \
+   double                       ode_tolerance   ,   \
+   const CppAD::vector<double>& age             ,   \
+   const Float&                 pini            ,   \
+   const CppAD::vector<Float>&  iota            ,   \
+   const CppAD::vector<Float>&  rho             ,   \
+   const CppAD::vector<Float>&  chi             ,   \
+   const CppAD::vector<Float>&  omega           ,   \
+   CppAD::vector<Float>&        s_out           ,   \
+   CppAD::vector<Float>&        c_out               \
+   );                                               \
    template void cohort_ode<Float>(                 \
    const std::string&           rate_case       ,   \
+   double                       ode_tolerance   ,   \
    const CppAD::vector<double>& age             ,   \
    const Float&                 pini            ,   \
    const CppAD::vector<Float>&  iota            ,   \
@@ -0,0 +1,232 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-23 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin counter_rng dev}
+{xrst_spell
+   gsl
+   philox
+   rng
+}
+
+Counter Based Random Number Streams
+###################################
+
+Syntax
+******
+
+| ``set_counter_seed`` ( *seed* )
+| *seed* = ``get_counter_seed`` ()
+| ``counter_rng`` *counter*
+| *rng* = *counter* . ``start`` ( *stream* , *index_0* , *index_1* )
+
+Prototype
+*********
+{xrst_literal
+   include/dismod_at/counter_rng.hpp
+   // BEGIN_COUNTER_RNG_PROTOTYPE
+   // END_COUNTER_RNG_PROTOTYPE
+}
+
+Purpose
+*******
+The generator managed by :ref:`manage_gsl_rng-name` is one sequence,
+so the values a simulation gets depend on the order of the simulations.
+This routine uses the Philox4x32-10 counter based generator,
+where each random value is a function of a key and a counter.
+The key is the *seed* and the counter contains
+( *stream* , *index_0* , *index_1* ) .
+Hence the values for one ( *stream* , *index_0* , *index_1* )
+do not depend on which other streams were used, or in which order,
+and different threads can generate different streams at the same time.
+
+seed
+****
+This is the seed used for the key by all the streams.
+It is set by ``set_counter_seed`` and its value is zero,
+until it is set for the first time.
+The ``dismod_at`` program sets it to the same value as the
+:ref:`manage_gsl_rng-name` seed; see
+:ref:`option_table@random_seed` .
+This routine is not thread safe; i.e., it must be called
+when not running in parallel.
+
+counter
+*******
+This object holds the state for one stream.
+One thread can use a *counter* object while other threads use
+other *counter* objects.
+
+stream
+******
+Different values of *stream* generate different random values
+for the same *index_0* and *index_1* .
+Each use of random numbers (e.g., simulating data) has its own
+*stream* value.
+
+index_0, index_1
+****************
+These identify the random sequence within the stream;
+e.g., the :ref:`data_sim_table@simulate_index` and
+:ref:`data_table@data_id` for one simulated measurement.
+(The data_id is used, instead of the data_subset_id,
+so the simulated value for a data table row does not depend on
+which other rows are in the data subset.)
+They must be less than :math:`2^{32}`.
+
+rng
+***
+The return value is a GSL random number generator
+that starts at the beginning of the sequence for
+( *stream* , *index_0* , *index_1* ) .
+It can be used with the GSL random distribution routines; e.g.,
+``gsl_ran_gaussian`` and ``gsl_ran_choose`` .
+It is owned by *counter* and is valid until the next call to *start*
+or until *counter* is deleted.
+Each value has 32 random bits; i.e.,
+``gsl_rng_max`` ( *rng* ) is :math:`2^{32} - 1`.
+{xrst_toc_hidden
+   example/devel/utility/counter_rng_xam.cpp
+}
+Example
+*******
+The file :ref:`counter_rng_xam.cpp-name` contains an example and test
+of this routine.
+
+{xrst_end counter_rng}
+-------------------------------------------------------------------------------
+*/
+# include <cassert>
+# include <cstdint>
+# include <dismod_at/counter_rng.hpp>
+
+namespace {
+   // seed_
+   size_t seed_ = 0;
+   //
+   // state_struct
+   struct state_struct {
+      uint32_t key[2];
+      uint32_t ctr[4];
+      uint32_t out[4];
+      size_t   n_used;
+   };
+   //
+   // philox4x32_10
+   // out = Philox4x32-10 block corresponding to ctr and key
+   void philox4x32_10(
+      const uint32_t ctr[4], const uint32_t key[2], uint32_t out[4] )
+   {  const uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+      const uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+      uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+      uint32_t k0 = key[0], k1 = key[1];
+      for(size_t round = 0; round < 10; ++round)
+      {  uint64_t p0  = uint64_t(M0) * uint64_t(c0);
+         uint64_t p1  = uint64_t(M1) * uint64_t(c2);
+         uint32_t hi0 = uint32_t(p0 >> 32);
+         uint32_t lo0 = uint32_t(p0);
+         uint32_t hi1 = uint32_t(p1 >> 32);
+         uint32_t lo1 = uint32_t(p1);
+         c0  = hi1 ^ c1 ^ k0;
+         c1  = lo1;
+         c2  = hi0 ^ c3 ^ k1;
+         c3  = lo0;
+         k0 += W0;
+         k1 += W1;
+      }
+      out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+   }
+   //
+   // philox_set
+   // gsl_rng_set interface: seed becomes the key, start at counter zero
+   void philox_set(void* vstate, unsigned long int seed)
+   {  state_struct* state = static_cast<state_struct*>(vstate);
+      uint64_t seed_64 = uint64_t(seed);
+      state->key[0]    = uint32_t(seed_64);
+      state->key[1]    = uint32_t(seed_64 >> 32);
+      for(size_t i = 0; i < 4; ++i)
+         state->ctr[i] = 0;
+      philox4x32_10(state->ctr, state->key, state->out);
+      state->n_used = 0;
+   }
+   //
+   // philox_get
+   // gsl_rng_get interface: next 32 random bits
+   unsigned long int philox_get(void* vstate)
+   {  state_struct* state = static_cast<state_struct*>(vstate);
+      if( state->n_used == 4 )
+      {  // next block in this sequence
+         ++state->ctr[0];
+         philox4x32_10(state->ctr, state->key, state->out);
+         state->n_used = 0;
+      }
+      return state->out[ state->n_used++ ];
+   }
+   //
+   // philox_get_double
+   // gsl_rng_uniform interface: uniform on [0, 1)
+   double philox_get_double(void* vstate)
+   {  return double( philox_get(vstate) ) / 4294967296.0;
+   }
+   //
+   // philox_type
+   const gsl_rng_type philox_type = {
+      "dismod_at_philox4x32_10" , // name
+      0xffffffffUL              , // max
+      0                         , // min
+      sizeof(state_struct)      , // size
+      &philox_set               ,
+      &philox_get               ,
+      &philox_get_double
+   };
+}
+
+namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
+
+// set_counter_seed
+void set_counter_seed(size_t seed)
+{  seed_ = seed; }
+
+// get_counter_seed
+size_t get_counter_seed(void)
+{  return seed_; }
+
+// counter_rng
+counter_rng::counter_rng(void)
+: rng_( gsl_rng_alloc(&philox_type) )
+{ }
+
+// ~counter_rng
+counter_rng::~counter_rng(void)
+{  gsl_rng_free(rng_); }
+
+// start
+gsl_rng* counter_rng::start(
+   counter_stream_enum stream  ,
+   size_t              index_0 ,
+   size_t              index_1 )
+{  assert( uint64_t(index_0) <= uint64_t(0xffffffff) );
+   assert( uint64_t(index_1) <= uint64_t(0xffffffff) );
+   //
+   // key
+   state_struct* state = static_cast<state_struct*>(rng_->state);
+   uint64_t seed_64 = uint64_t(seed_);
+   state->key[0]    = uint32_t(seed_64);
+   state->key[1]    = uint32_t(seed_64 >> 32);
+   //
+   // ctr
+   // ctr[0] is the block index within this sequence
+   state->ctr[0] = 0;
+   state->ctr[1] = uint32_t(stream);
+   state->ctr[2] = uint32_t(index_0);
+   state->ctr[3] = uint32_t(index_1);
+   //
+   // out, n_used
+   philox4x32_10(state->ctr, state->key, state->out);
+   state->n_used = 0;
+   //
+   return rng_;
+}
+
+} // END_DISMOD_AT_NAMESPACE
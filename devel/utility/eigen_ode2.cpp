@@ -20,7 +20,8 @@ Eigen Vector Solution of ODE with Two Components
 Syntax
 ******
 
-   *yf* = ``eigen_ode2`` ( *case_number* , *b* , *yi* , *tf* )
+| *yf* = ``eigen_ode2`` ( *case_number* , *b* , *yi* , *tf* )
+| *yf* = ``eigen_ode2<`` *case_number* , *Float* > ( *b* , *yi* , *tf* )
 
 Purpose
 *******
@@ -119,6 +120,10 @@ This argument has prototype
 
    ``size_t`` *case_number*
 
+In the second syntax, *case_number* is a template parameter
+and the choice between the cases below is made at compile time.
+The first syntax chooses the case at run time and then uses the second.
+
 One
 ===
 The case where :math:`b_1 = 0` and :math:`b_2 = 0` we denote by
@@ -412,45 +417,72 @@ namespace {
    }
 }
 
-template <class Float>
+template <size_t case_number, class Float>
 CppAD::vector<Float> eigen_ode2(
-   size_t                       case_number ,
    const CppAD::vector<Float>&  b           ,
    const CppAD::vector<Float>&  yi          ,
    const Float&                 tf          )
-{  using CppAD::abs;
-   using CppAD::exp;
-   using CppAD::sqrt;
-   //
+{  static_assert( 1 <= case_number && case_number <= 4 );
    assert( b.size() == 4 );
    assert( yi.size() == 2 );
-   assert( 1 <= case_number && case_number <= 4 );
-   CppAD::vector<Float> yf(2);
-
+   //
    // solution corresponding to b_1 = b_2 = 0
-   if( case_number == 1 )
-   {  return both_zero(b, yi, tf);
-   }
-
+   if constexpr( case_number == 1 )
+      return both_zero(b, yi, tf);
+   //
    // case for which we switch the order of the rows and columns
-   if( case_number == 2 )
+   else if constexpr( case_number == 2 )
       return b2_zero(b, yi, tf);
    //
-   if( case_number == 3 )
+   else if constexpr( case_number == 3 )
       return b1_zero(b, yi, tf);
    //
+   else
+      return both_nonzero(b, yi, tf);
+}
+
+template <class Float>
+CppAD::vector<Float> eigen_ode2(
+   size_t                       case_number ,
+   const CppAD::vector<Float>&  b           ,
+   const CppAD::vector<Float>&  yi          ,
+   const Float&                 tf          )
+{  assert( 1 <= case_number && case_number <= 4 );
+   switch( case_number )
+   {  case 1:
+      return eigen_ode2<1, Float>(b, yi, tf);
+
+      case 2:
+      return eigen_ode2<2, Float>(b, yi, tf);
+
+      case 3:
+      return eigen_ode2<3, Float>(b, yi, tf);
+
+      default:
+      break;
+   }
    assert( case_number == 4 );
-   return both_nonzero(b, yi, tf);
+   return eigen_ode2<4, Float>(b, yi, tf);
 }
 
-// instantiation macro
+// instantiation macros
+# define DISMOD_AT_INSTANTIATE_EIGEN_ODE2_CASE(case_number, Float) \
+   template CppAD::vector<Float> eigen_ode2<case_number, Float>(  \
+      const CppAD::vector<Float>&  b           ,                  \
+      const CppAD::vector<Float>&  yi          ,                  \
+      const Float&                 tf                             \
+   );
 # define DISMOD_AT_INSTANTIATE_EIGEN_ODE2(Float)       \
    template CppAD::vector<Float> eigen_ode2<Float>(   \
       size_t                       case_number ,     \
       const CppAD::vector<Float>&  b           ,     \
       const CppAD::vector<Float>&  yi          ,     \
       const Float&                 tf                \
-   );
+   );                                                \
+   DISMOD_AT_INSTANTIATE_EIGEN_ODE2_CASE(1, Float)   \
+   DISMOD_AT_INSTANTIATE_EIGEN_ODE2_CASE(2, Float)   \
+   DISMOD_AT_INSTANTIATE_EIGEN_ODE2_CASE(3, Float)   \
+   DISMOD_AT_INSTANTIATE_EIGEN_ODE2_CASE(4, Float)
 
 // instantiations
 DISMOD_AT_INSTANTIATE_EIGEN_ODE2( double )
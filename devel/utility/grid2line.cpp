@@ -44,17 +44,11 @@ line_age
 ********
 This vector has size *n_line* and contains the age value
 corresponding to each of the points in the line.
-It is faster if successive points have close values in age; e.g.,
-
-   *line_age* [ *k* ] <= *line_age* [ *k* +1]
 
 line_time
 *********
 This vector has size *n_line* and contains the time value
 corresponding to each of the points in the line.
-It is faster if successive points have close values in time; e.g.,
-
-   *line_time* [ *k* ] <= *line_time* [ *k* +1]
 
 age_table
 *********
@@ -92,6 +86,12 @@ age *line_age* [ *i* ] and time *line_time* [ *i* ] .
 {xrst_toc_hidden
    example/devel/utility/grid2line_xam.cpp
 }
+Stencil
+*******
+This routine uses a :ref:`grid2line_stencil-name` to do the interpolation.
+If the same line and grid age and time values are used for many
+interpolations, it is faster to use the stencil directly.
+
 Example
 *******
 The file :ref:`grid2line_xam.cpp-name` contains an example and test
@@ -99,6 +99,7 @@ of using this routine.
 
 {xrst_end grid2line}
 */
+# include <algorithm>
 # include <dismod_at/grid2line.hpp>
 # include <dismod_at/a1_double.hpp>
 # include <dismod_at/smooth_info.hpp>
@@ -120,119 +121,198 @@ CppAD::vector<Float> grid2line(
 {  //
    assert( line_age.size() == line_time.size() );
    //
-   size_t n_line = line_age.size();
-   CppAD::vector<Float> line_value(n_line);
+   grid2line_stencil stencil;
+   stencil.set(line_age, line_time, age_table, time_table, g_info);
+   //
+   CppAD::vector<Float> line_value( line_age.size() );
+   stencil.eval(grid_value, line_value);
+   //
+   return line_value;
+}
+/*
+------------------------------------------------------------------------------
+{xrst_begin grid2line_stencil dev}
+
+Bilinear Interpolation Stencil from a Grid to a Line
+####################################################
+
+Syntax
+******
+
+| ``grid2line_stencil`` *stencil*
+| *stencil* . ``set`` (
+| *line_age* , *line_time* , *age_table* , *time_table* , *g_info*
+| )
+| *n_line* = *stencil* . ``size`` ()
+| *stencil* . ``eval`` ( *grid_value* , *line_value* )
+
+Prototype
+*********
+{xrst_literal
+   include/dismod_at/grid2line.hpp
+   // BEGIN_GRID2LINE_STENCIL_PROTOTYPE
+   // END_GRID2LINE_STENCIL_PROTOTYPE
+}
+
+Purpose
+*******
+The :ref:`grid2line-name` interpolation only depends on the
+age and time values for the line and grid, not on the values on the grid.
+The stencil stores, for each point in the line,
+the index of the four grid points that surround it and the
+corresponding bilinear coefficients.
+It can be used for any *Float* type and for any grid that has the
+same age and time values as *g_info* .
+
+set
+***
+The arguments *line_age* , *line_time* , *age_table* , *time_table* ,
+and *g_info* have the same meaning as in :ref:`grid2line-name` .
+The grid interval containing each line point is found using
+a binary search.
+Memory allocated by a previous call to ``set`` is re-used when possible.
+
+size
+****
+The return value *n_line* is the number of points in the line
+for the previous call to ``set`` .
+
+eval
+****
+The argument *grid_value* has the same meaning as in
+:ref:`grid2line-name` .
+The vector *line_value* must have size *n_line* and
+upon return it is equal to the corresponding :ref:`grid2line-name`
+return value.
+Each *line_value* [ *k* ] is a sum of four coefficients times grid values.
+The coefficients that are not needed
+(when age or time is outside the grid) are zero.
+
+{xrst_end grid2line_stencil}
+*/
+// grid2line_stencil
+grid2line_stencil::grid2line_stencil(void)
+: n_line_(0)
+{ }
+//
+// size
+size_t grid2line_stencil::size(void) const
+{  return n_line_; }
+//
+// set
+template <class Grid_info>
+void grid2line_stencil::set(
+   const CppAD::vector<double>& line_age     ,
+   const CppAD::vector<double>& line_time    ,
+   const CppAD::vector<double>& age_table    ,
+   const CppAD::vector<double>& time_table   ,
+   const Grid_info&             g_info       )
+{  assert( line_age.size() == line_time.size() );
+   //
+   n_line_ = line_age.size();
+   index_.resize(4 * n_line_);
+   coef_.resize(4 * n_line_);
    //
    // number of age and time points in the grid
    size_t n_age  = g_info.age_size();
    size_t n_time = g_info.time_size();
    //
-   double age_min  = age_table[  g_info.age_id(0) ];
-   double time_min = time_table[ g_info.time_id(0) ];
+   // grid_age_, grid_time_
+   grid_age_.resize(n_age);
+   grid_time_.resize(n_time);
+   for(size_t i = 0; i < n_age; ++i)
+      grid_age_[i] = age_table[ g_info.age_id(i) ];
+   for(size_t j = 0; j < n_time; ++j)
+      grid_time_[j] = time_table[ g_info.time_id(j) ];
    //
-   double age_max  = age_table[  g_info.age_id(n_age - 1) ];
-   double time_max = time_table[ g_info.time_id(n_time - 1) ];
+   double age_min  = grid_age_[0];
+   double time_min = grid_time_[0];
+   double age_max  = grid_age_[n_age - 1];
+   double time_max = grid_time_[n_time - 1];
    //
-   size_t i = 1;
-   size_t j = 1;
-   for(size_t k = 0; k < n_line; ++k)
+   const double* age_begin  = grid_age_.data();
+   const double* time_begin = grid_time_.data();
+   for(size_t k = 0; k < n_line_; ++k)
    {  double age      = line_age[k];
       double time     = line_time[k];
       //
-      // determine interval for this age
-      bool one_age;
-      if( age <= age_min )
-      {  one_age = true;
-         i       = 0;
-      }
-      else if( age_max <= age )
-      {  one_age = true;
-         i       = n_age - 1;
-      }
-      else
-      {  one_age = false;
-         while( i < n_age - 1 && age_table[ g_info.age_id(i) ] < age )
-            ++i;
-         while( 1 < i && age < age_table[ g_info.age_id(i-1) ] )
-            --i;
-      }
-      //
-      // determine interval for this time
-      bool one_time;
-      if( time <= time_min )
-      {  one_time = true;
-         j        = 0;
-      }
-      else if( time_max <= time )
-      {  one_time = true;
-         j        = n_time - 1;
+      // determine interval for this age: age_m <= age <= age_p
+      size_t i_m, i_p;
+      double c_m, c_p;
+      if( age <= age_min || age_max <= age )
+      {  i_m = i_p = age <= age_min ? 0 : n_age - 1;
+         c_m = 0.0;
+         c_p = 1.0;
       }
       else
-      {  one_time = false;
-         while( j < n_time - 1 && time_table[ g_info.time_id(j) ] < time )
-            ++j;
-         while( 1 < j && time < time_table[ g_info.time_id(j-1) ] )
-            --j;
-      }
-      // index in grid_value corresponding to grid point (i, j)
-      size_t ij_smooth = i * n_time + j;
-      //
-      // result of the interpolation for this point on the line
-      Float res = Float(0);
-      //
-      // case with no interpolation
-      if( one_age & one_time )
-         res =  grid_value[ij_smooth];
-      else if( one_time )
-      {  // case with only age interpolation
-         assert( i > 0 );
-         Float  vp = grid_value[ij_smooth];
-         double ap = age_table[ g_info.age_id(i) ];
-         Float  vm = grid_value[ij_smooth - n_time];
-         double am = age_table[ g_info.age_id(i - 1) ];
+      {  i_p = size_t(
+            std::lower_bound(age_begin, age_begin + n_age, age) - age_begin
+         );
+         assert( 0 < i_p && i_p < n_age );
+         i_m        = i_p - 1;
+         double ap  = grid_age_[i_p];
+         double am  = grid_age_[i_m];
          assert( am <= age && age <= ap );
-         res       = vm * (ap - age);
-         res      += vp * (age - am);
-         res      /= (ap - am);
+         c_m = (ap - age) / (ap - am);
+         c_p = (age - am) / (ap - am);
       }
-      else if( one_age )
-      {  // case with only time interpolation
-         assert( j > 0 );
-         Float  vp = grid_value[ij_smooth];
-         double tp = time_table[ g_info.time_id(j) ];
-         Float  vm = grid_value[ij_smooth - 1];
-         double tm = time_table[ g_info.time_id(j - 1) ];
-         assert( tm <= time && time <= tp );
-         res       = vm * (tp - time);
-         res      += vp * (time - tm);
-         res      /= (tp - tm);
+      //
+      // determine interval for this time: time_m <= time <= time_p
+      size_t j_m, j_p;
+      double d_m, d_p;
+      if( time <= time_min || time_max <= time )
+      {  j_m = j_p = time <= time_min ? 0 : n_time - 1;
+         d_m = 0.0;
+         d_p = 1.0;
       }
       else
-      {  // interpolate in both age and time
-         assert( i > 0 );
-         assert( j > 0 );
-         double ap  = age_table[ g_info.age_id(i) ];
-         double am  = age_table[ g_info.age_id(i - 1) ];
-         double tp  = time_table[ g_info.time_id(j) ];
-         double tm  = time_table[ g_info.time_id(j - 1) ];
-         Float  vpp = grid_value[ij_smooth];
-         Float  vmp = grid_value[ij_smooth - n_time];
-         Float  vpm = grid_value[ij_smooth - 1];
-         Float  vmm = grid_value[ij_smooth - n_time - 1];
-         assert( am <= age && age <= ap );
+      {  j_p = size_t(
+            std::lower_bound(time_begin, time_begin + n_time, time)
+            - time_begin
+         );
+         assert( 0 < j_p && j_p < n_time );
+         j_m        = j_p - 1;
+         double tp  = grid_time_[j_p];
+         double tm  = grid_time_[j_m];
          assert( tm <= time && time <= tp );
-         res        = vpp * (age - am) * (time - tm);
-         res       += vmm * (ap - age) * (tp - time);
-         res       += vmp * (ap - age) * (time - tm);
-         res       += vpm * (age - am) * (tp - time);
-         res       /=(ap - am) * (tp - tm);
+         d_m = (tp - time) / (tp - tm);
+         d_p = (time - tm) / (tp - tm);
       }
+      //
+      // four corners for this point in the line
+      size_t ell = 4 * k;
+      index_[ell + 0] = i_p * n_time + j_p;
+      index_[ell + 1] = i_m * n_time + j_p;
+      index_[ell + 2] = i_p * n_time + j_m;
+      index_[ell + 3] = i_m * n_time + j_m;
+      coef_[ell + 0]  = c_p * d_p;
+      coef_[ell + 1]  = c_m * d_p;
+      coef_[ell + 2]  = c_p * d_m;
+      coef_[ell + 3]  = c_m * d_m;
+   }
+}
+//
+// eval
+template <class Float>
+void grid2line_stencil::eval(
+   const CppAD::vector<Float>&  grid_value   ,
+   CppAD::vector<Float>&        line_value   ) const
+{  assert( line_value.size() == n_line_ );
+   //
+   const size_t* index = index_.data();
+   const double* coef  = coef_.data();
+   for(size_t k = 0; k < n_line_; ++k)
+   {  // a coefficient that is zero does not add to an AD tape
+      Float res  = coef[0] * grid_value[ index[0] ];
+      res       += coef[1] * grid_value[ index[1] ];
+      res       += coef[2] * grid_value[ index[2] ];
+      res       += coef[3] * grid_value[ index[3] ];
       line_value[k] = res;
+      index += 4;
+      coef  += 4;
    }
-   return line_value;
 }
 
-
 // instantiation
 # define DISMOD_AT_INSTANTIATE_GRID2LINE(Grid_info, Float)  \
 template CppAD::vector<Float> grid2line(                    \
@@ -250,4 +330,25 @@ DISMOD_AT_INSTANTIATE_GRID2LINE( smooth_info, double )
 DISMOD_AT_INSTANTIATE_GRID2LINE( weight_info, a1_double )
 DISMOD_AT_INSTANTIATE_GRID2LINE( smooth_info, a1_double )
 
+// grid2line_stencil instantiation
+# define DISMOD_AT_INSTANTIATE_GRID2LINE_STENCIL_SET(Grid_info)  \
+template void grid2line_stencil::set(                           \
+   const CppAD::vector<double>& line_age     ,                  \
+   const CppAD::vector<double>& line_time    ,                  \
+   const CppAD::vector<double>& age_table    ,                  \
+   const CppAD::vector<double>& time_table   ,                  \
+   const Grid_info&             g_info                          \
+);
+# define DISMOD_AT_INSTANTIATE_GRID2LINE_STENCIL_EVAL(Float)     \
+template void grid2line_stencil::eval(                          \
+   const CppAD::vector<Float>&  grid_value   ,                  \
+   CppAD::vector<Float>&        line_value                      \
+) const;
+
+DISMOD_AT_INSTANTIATE_GRID2LINE_STENCIL_SET( weight_info )
+DISMOD_AT_INSTANTIATE_GRID2LINE_STENCIL_SET( smooth_info )
+//
+DISMOD_AT_INSTANTIATE_GRID2LINE_STENCIL_EVAL( double )
+DISMOD_AT_INSTANTIATE_GRID2LINE_STENCIL_EVAL( a1_double )
+
 } // END DISMOD_AT_NAMESPACE
@@ -0,0 +1,226 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-23 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin ode2_chkpoint dev}
+{xrst_spell
+   chkpoint
+   tf
+   yf
+   yi
+}
+
+One ODE Step as a CppAD Checkpoint Function
+###########################################
+
+Syntax
+******
+
+| ``ode2_chkpoint_setup`` ()
+| *yf* = ``ode2_chkpoint`` ( *case_number* , *b* , *yi* , *tf* )
+
+Prototype
+*********
+{xrst_literal
+   // BEGIN_SETUP_PROTOTYPE
+   // END_SETUP_PROTOTYPE
+}
+{xrst_literal
+   // BEGIN_PROTOTYPE
+   // END_PROTOTYPE
+}
+
+Purpose
+*******
+When the :ref:`a1_double-name` operations for
+:ref:`eigen_ode2-name` are recorded,
+each step uses many operations (exp, sqrt, conditional expressions,
+divisions, ...).
+This routine computes the same step, but only one
+``CppAD::chkpoint_two`` atomic operation is recorded for each step.
+This greatly reduces the size of the tapes that contain
+solutions of the ODE; e.g., the data likelihood tapes in :ref:`fit_model-name`.
+The derivatives of the atomic operation (of any order, and for the
+``base2ad`` version of a tape) are computed by CppAD using a tape
+of the step that is recorded once for each *case_number* .
+
+ode2_chkpoint_setup
+*******************
+This routine records the step tape for every *case_number*
+and creates the corresponding checkpoint functions.
+It must be called before the first call to ``ode2_chkpoint``
+that has a variable argument
+and while there is no ``a1_double`` recording in progress
+(CppAD does not allow a new tape to be started while another is active).
+The ``dismod_at`` program calls it once before any command is run.
+It is also called by the :ref:`fit_model_ctor-name` and by
+:ref:`data_depend-name` , before they record ``a1_double`` tapes,
+so that these routines can be used without the ``dismod_at`` program.
+Calls after the first one do nothing.
+
+case_number
+***********
+If *case_number* is zero, the step is computed using
+:ref:`trap_ode2-name` .
+Otherwise it is the :ref:`eigen_ode2@case_number`
+for the step computed using ``eigen_ode2`` .
+
+b
+*
+This vector has size four and is the
+:ref:`eigen_ode2@b` argument for the step.
+
+yi
+**
+This vector has size two and is the
+:ref:`eigen_ode2@yi` argument for the step.
+
+tf
+**
+This is the
+:ref:`eigen_ode2@tf` argument for the step.
+
+yf
+**
+This vector has size two and is the solution of the ODE at *tf* .
+It is equal to the corresponding value for
+``trap_ode2`` or ``eigen_ode2`` .
+If none of the arguments *b* , *yi* , *tf* is a variable,
+the step is computed using ``trap_ode2`` or ``eigen_ode2``
+and no checkpoint operation is used.
+
+Parallel Mode
+*************
+The checkpoint functions are created by ``ode2_chkpoint_setup``
+and cannot be used in parallel mode.
+This is not a restriction because ``a1_double`` operations are
+never computed in parallel by ``dismod_at`` .
+
+{xrst_toc_hidden
+   example/devel/utility/ode2_chkpoint_xam.cpp
+}
+Example
+*******
+The file :ref:`ode2_chkpoint_xam.cpp-name` contains
+an example and test of ``ode2_chkpoint`` .
+It returns true for success and false for failure.
+
+{xrst_end ode2_chkpoint}
+---------------------------------------------------------------------------
+*/
+# include <memory>
+# include <cassert>
+# include <cppad/cppad.hpp>
+# include <dismod_at/ode2_chkpoint.hpp>
+# include <dismod_at/error_exit.hpp>
+# include <dismod_at/eigen_ode2.hpp>
+# include <dismod_at/trap_ode2.hpp>
+
+namespace { // BEGIN_EMPTY_NAMESPACE
+   using dismod_at::a1_double;
+   //
+   // number of case numbers including zero for trap_ode2
+   const size_t n_case_ = 5;
+   //
+   // record_step
+   // The operation sequence for a step does not depend on the values
+   // of the independent variables; see eigen_ode2.
+   CppAD::ADFun<double> record_step(size_t case_number)
+   {  // ax = (b, yi, tf)
+      CppAD::vector<a1_double> ax(7), b(4), yi(2), ay(2);
+      ax[0] = -1.0;
+      ax[1] =  0.5;
+      ax[2] =  0.5;
+      ax[3] = -2.0;
+      ax[4] =  0.9;
+      ax[5] =  0.1;
+      ax[6] =  1.0;
+      CppAD::Independent(ax);
+      for(size_t i = 0; i < 4; ++i)
+         b[i] = ax[i];
+      yi[0]        = ax[4];
+      yi[1]        = ax[5];
+      a1_double tf = ax[6];
+      if( case_number == 0 )
+         ay = dismod_at::trap_ode2(b, yi, tf);
+      else
+         ay = dismod_at::eigen_ode2(case_number, b, yi, tf);
+      CppAD::ADFun<double> fun(ax, ay);
+      fun.optimize();
+      return fun;
+   }
+   //
+   // chk_
+   std::unique_ptr< CppAD::chkpoint_two<double> > chk_[n_case_];
+   //
+   // get_chkpoint
+   CppAD::chkpoint_two<double>& get_chkpoint(size_t case_number)
+   {  assert( case_number < n_case_ );
+      if( chk_[case_number] == nullptr )
+      {  std::string msg = "ode2_chkpoint: ode2_chkpoint_setup not called";
+         dismod_at::error_exit(msg);
+      }
+      return *chk_[case_number];
+   }
+} // END_EMPTY_NAMESPACE
+
+namespace dismod_at { // BEGIN DISMOD_AT_NAMESPACE
+
+// BEGIN_SETUP_PROTOTYPE
+void ode2_chkpoint_setup(void)
+// END_SETUP_PROTOTYPE
+{  for(size_t case_number = 0; case_number < n_case_; ++case_number)
+   {  if( chk_[case_number] == nullptr )
+      {  CppAD::ADFun<double> fun = record_step(case_number);
+         std::string name = "ode2_chkpoint_";
+         name            += CppAD::to_string(case_number);
+         bool internal_bool    = false;
+         bool use_hes_sparsity = true;
+         bool use_base2ad      = true;
+         bool use_in_parallel  = false;
+         chk_[case_number].reset( new CppAD::chkpoint_two<double>(
+            fun,
+            name,
+            internal_bool,
+            use_hes_sparsity,
+            use_base2ad,
+            use_in_parallel
+         ) );
+      }
+   }
+   return;
+}
+
+// BEGIN_PROTOTYPE
+CppAD::vector<a1_double> ode2_chkpoint(
+   size_t                           case_number ,
+   const CppAD::vector<a1_double>&  b           ,
+   const CppAD::vector<a1_double>&  yi          ,
+   const a1_double&                 tf          )
+// END_PROTOTYPE
+{  assert( b.size() == 4 );
+   assert( yi.size() == 2 );
+   //
+   CppAD::vector<a1_double> ax(7), ay(2);
+   for(size_t i = 0; i < 4; ++i)
+      ax[i] = b[i];
+   ax[4] = yi[0];
+   ax[5] = yi[1];
+   ax[6] = tf;
+   //
+   // If no argument is a variable, nothing is being recorded for this step
+   // and the checkpoint function is not needed.
+   bool variable = false;
+   for(size_t i = 0; i < 7; ++i)
+      variable |= CppAD::Variable( ax[i] );
+   if( ! variable )
+   {  if( case_number == 0 )
+         return trap_ode2(b, yi, tf);
+      return eigen_ode2(case_number, b, yi, tf);
+   }
+   get_chkpoint(case_number)(ax, ay);
+   return ay;
+}
+
+} // END DISMOD_AT_NAMESPACE
@@ -0,0 +1,185 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-23 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin pack_fit_hes dev}
+{xrst_spell
+   rcv
+}
+Packing and Unpacking Fit Hessians in a Vector
+##############################################
+
+Syntax
+******
+
+| *vec* = ``pack_fit_hes`` (
+| |tab| *sim_index* , *bound_random* , *input_hash* ,
+| |tab| *fit_var_value* , *hes_fixed* , *hes_random*
+| )
+| ``unpack_fit_hes`` (
+| |tab| *vec* , *sim_index* , *bound_random* , *input_hash* ,
+| |tab| *fit_var_value* , *hes_fixed* , *hes_random*
+| )
+
+Prototype
+*********
+{xrst_literal
+   // BEGIN_PACK
+   // END_PACK
+}
+{xrst_literal
+   // BEGIN_UNPACK
+   // END_UNPACK
+}
+
+vec
+***
+This is a single vector that contains a copy of the
+other arguments.
+It is written to the :ref:`fit_command@Output Tables@fit_hes`
+table by the fit command and read by the
+:ref:`sample asymptotic<sample_command@asymptotic>` command.
+
+sim_index
+*********
+This is the :ref:`fit_command@simulate_index` for the fit,
+or -1 if the fit used the measurement values in the data table.
+
+bound_random
+************
+This is the
+:ref:`option_table@Optimize Random Only@bound_random`
+used by the fit (infinity corresponds to null).
+The Hessians are only saved by fit :ref:`fit_command@variables@both`
+and they depend on this bound; i.e., which random effects are constant.
+
+input_hash
+**********
+This is the :ref:`fit_input_hash-name` for the database
+when the fit was run.
+If the options, priors, data, or data_subset table change after the fit,
+this hash code changes and the Hessians no longer apply.
+
+fit_var_value
+*************
+This is the optimal value for the
+:ref:`model_variables-name` in :ref:`pack_info-name` order.
+We use *n_var* to denote its size.
+
+hes_fixed
+*********
+This is the Hessian of the fixed effects objective
+evaluated at *fit_var_value* ; see
+:ref:`fit_model_fixed_obj_hes-name` .
+The number of rows and columns in this matrix is *n_var* .
+
+hes_random
+**********
+This is the Hessian of the random effects objective
+evaluated at *fit_var_value* ; see
+:ref:`fit_model_random_obj_hes-name` .
+The number of rows and columns in this matrix is *n_var* .
+
+{xrst_end pack_fit_hes}
+*/
+# include <dismod_at/pack_fit_hes.hpp>
+
+namespace {
+   // append a sparse matrix to vec
+   void pack_rcv(
+      CppAD::vector<double>&             vec   ,
+      size_t&                            index ,
+      const CppAD::mixed::d_sparse_rcv&  rcv   )
+   {  size_t nnz = rcv.nnz();
+      vec[index++] = double(nnz);
+      for(size_t k = 0; k < nnz; ++k)
+      {  vec[index++] = double( rcv.row()[k] );
+         vec[index++] = double( rcv.col()[k] );
+         vec[index++] = rcv.val()[k];
+      }
+   }
+   // extract a sparse matrix from vec
+   CppAD::mixed::d_sparse_rcv unpack_rcv(
+      const CppAD::vector<double>&       vec   ,
+      size_t&                            index ,
+      size_t                             n_var )
+   {  size_t nnz   = size_t( vec[index++] );
+      size_t start = index;
+      CppAD::mixed::sparse_rc pattern(n_var, n_var, nnz);
+      for(size_t k = 0; k < nnz; ++k)
+      {  size_t r = size_t( vec[index++] );
+         size_t c = size_t( vec[index++] );
+         ++index;
+         pattern.set(k, r, c);
+      }
+      CppAD::mixed::d_sparse_rcv rcv( pattern );
+      index = start;
+      for(size_t k = 0; k < nnz; ++k)
+      {  index += 2;
+         rcv.set(k, vec[index++] );
+      }
+      return rcv;
+   }
+}
+
+namespace dismod_at {
+
+// BEGIN_PACK
+CppAD::vector<double> pack_fit_hes(
+   int                                sim_index      ,
+   double                             bound_random   ,
+   double                             input_hash     ,
+   const CppAD::vector<double>&       fit_var_value  ,
+   const CppAD::mixed::d_sparse_rcv&  hes_fixed      ,
+   const CppAD::mixed::d_sparse_rcv&  hes_random     )
+// END_PACK
+{  size_t n_var = fit_var_value.size();
+   assert( hes_fixed.nr()  == n_var && hes_fixed.nc()  == n_var );
+   assert( hes_random.nr() == n_var && hes_random.nc() == n_var );
+   //
+   size_t size = 6 + n_var + 3 * ( hes_fixed.nnz() + hes_random.nnz() );
+   CppAD::vector<double> vec(size);
+   size_t index = 0;
+   vec[index++] = double(sim_index);
+   vec[index++] = bound_random;
+   vec[index++] = input_hash;
+   vec[index++] = double(n_var);
+   for(size_t i = 0; i < n_var; ++i)
+      vec[index++] = fit_var_value[i];
+   pack_rcv(vec, index, hes_fixed);
+   pack_rcv(vec, index, hes_random);
+   assert( index == vec.size() );
+   //
+   // check conversion from size_t to double
+   assert( size_t(vec[3]) == n_var );
+   return vec;
+}
+// BEGIN_UNPACK
+void unpack_fit_hes(
+   const CppAD::vector<double>&       vec            ,
+   int&                               sim_index      ,
+   double&                            bound_random   ,
+   double&                            input_hash     ,
+   CppAD::vector<double>&             fit_var_value  ,
+   CppAD::mixed::d_sparse_rcv&        hes_fixed      ,
+   CppAD::mixed::d_sparse_rcv&        hes_random     )
+// END_UNPACK
+{  size_t index = 0;
+   //
+   sim_index    = int( vec[index++] );
+   bound_random = vec[index++];
+   input_hash   = vec[index++];
+   //
+   size_t n_var = size_t( vec[index++] );
+   fit_var_value.resize(n_var);
+   for(size_t i = 0; i < n_var; ++i)
+      fit_var_value[i] = vec[index++];
+   //
+   hes_fixed  = unpack_rcv(vec, index, n_var);
+   hes_random = unpack_rcv(vec, index, n_var);
+   assert( index == vec.size() );
+   return;
+}
+
+} // END_DISMOD_AT_NAMESPACE
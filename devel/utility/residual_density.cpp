@@ -60,6 +60,11 @@ delta
 It is the standard deviation for the residual.
 For log data densities it is in log space.
 For all other cases, linear densities; i.e., it is in the same space as *mu* .
+If *d_enum* is not uniform, it must be greater than zero.
+If it is not, and we are in parallel mode; see
+:ref:`thread_pool@thread_pool_in_parallel` ,
+a ``std::runtime_error`` is thrown (because :ref:`error_exit-name`
+is not thread safe). Otherwise ``error_exit`` is called.
 
 d_enum
 ******
@@ -161,10 +166,12 @@ there is no absolute value term for this residual.
 
 {xrst_end residual_density}
 */
+# include <stdexcept>
 # include <cppad/cppad.hpp>
 # include <dismod_at/residual_density.hpp>
 # include <dismod_at/a1_double.hpp>
 # include <dismod_at/error_exit.hpp>
+# include <dismod_at/thread_pool.hpp>
 
 namespace {
    template <class Float>
@@ -285,6 +292,9 @@ residual_struct<Float> residual_density(
    {  std::string msg = "residual_density: delta = ";
       msg += CppAD::to_string(delta);
       msg += " is not greater than 0";
+      // error_exit is not thread safe
+      if( thread_pool_in_parallel() )
+         throw std::runtime_error(msg);
       error_exit(msg);
    }
 
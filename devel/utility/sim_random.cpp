@@ -19,12 +19,24 @@ Syntax
 
 | *z* = ``sim_random`` (
 | |tab| ``density`` , ``mu`` , ``delta`` , ``eta`` , ``nu`` )
+| *z* = ``sim_random`` (
+| |tab| ``rng`` , ``density`` , ``mu`` , ``delta`` , ``eta`` , ``nu`` )
 
 manage_gsl_rng
 **************
-The routine :ref:`manage_gsl_rng-name` sets up and controls the underlying
+If *rng* is not present,
+the routine :ref:`manage_gsl_rng-name` sets up and controls the underlying
 simulated random number generator.
 
+rng
+***
+This argument has prototype
+
+   ``gsl_rng*`` *rng*
+
+If it is present, it is the random number generator that is used;
+e.g., a :ref:`counter_rng-name` stream.
+
 density
 *******
 This argument has prototype
@@ -152,7 +164,17 @@ double sim_random(
    double       eta    ,
    double nu           )
 {  gsl_rng* rng = CppAD::mixed::get_gsl_rng();
-   //
+   return sim_random(rng, density, mu, delta, eta, nu);
+}
+
+double sim_random(
+   gsl_rng*     rng    ,
+   density_enum density,
+   double       mu     ,
+   double       delta  ,
+   double       eta    ,
+   double nu           )
+{  //
    assert( density != uniform_enum && density != binomial_enum );
    assert( delta > 0.0 );
    // -----------------------------------------------------------------------
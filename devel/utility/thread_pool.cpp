@@ -0,0 +1,317 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-23 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin thread_pool dev}
+{xrst_spell
+   cppad
+   alloc
+}
+
+Create, Use, And Free The Thread Pool
+#####################################
+
+Syntax
+******
+
+| ``new_thread_pool`` ( *n_thread* )
+| *size* = ``thread_pool_size`` ()
+| *thread* = ``thread_pool_num`` ()
+| *in_parallel* = ``thread_pool_in_parallel`` ()
+| ``thread_pool_run`` ( *n_job* , *job* )
+| ``free_thread_pool`` ()
+
+Prototype
+*********
+{xrst_literal
+   include/dismod_at/thread_pool.hpp
+   // BEGIN_THREAD_POOL_PROTOTYPE
+   // END_THREAD_POOL_PROTOTYPE
+}
+
+Purpose
+*******
+There is one thread pool for the entire program.
+It is used to evaluate independent ``double`` computations,
+e.g. the average integrand for different data points, in parallel.
+Computations that record ``a1_double`` operations must not be
+done in parallel because the recording is not thread safe.
+
+new_thread_pool
+***************
+This routine creates a thread pool with *n_thread* threads
+(including the thread that calls ``new_thread_pool`` ).
+If a previous thread pool was created, it must
+be freed using ``free_thread_pool`` before ``new_thread_pool``
+can be called again.
+This must be called in sequential mode.
+
+n_thread
+========
+This is the total number of threads and must be greater than zero.
+It must also be less than or equal ``CPPAD_MAX_NUM_THREADS`` .
+If it is one, no extra threads are created and
+``thread_pool_run`` executes its jobs sequentially.
+
+CppAD Memory Allocator
+======================
+If *n_thread* is greater than one,
+the CppAD ``thread_alloc`` memory allocator
+(which is used by ``CppAD::vector`` ) is informed about the threads.
+Memory allocated by one thread should only be returned by the same
+thread while in parallel mode.
+
+thread_pool_size
+****************
+The return value *size* is the number of threads in the current pool
+( *n_thread* in the previous call to ``new_thread_pool`` ).
+If there is no current pool, *size* is one.
+
+thread_pool_num
+***************
+The return value *thread* is the index of the current thread;
+i.e., ``0`` for the thread that called ``new_thread_pool``
+and between ``1`` and *size* ``-1`` for the other threads.
+Objects that have one work space for each thread should use
+*thread* to choose the work space.
+
+thread_pool_in_parallel
+***********************
+The return value *in_parallel* is true (false) if we are currently
+(are not currently) executing jobs in parallel.
+
+thread_pool_run
+***************
+This routine executes
+
+   *job* ( *job_index* )
+
+for *job_index* = 0 , ... , *n_job* ``-1`` .
+The jobs are distributed to the threads in the pool as they become available
+and the calling thread also executes jobs.
+This routine does not return until all the jobs have completed.
+The jobs must be independent; i.e., the result must not depend on the
+order in which they are executed.
+If ``thread_pool_run`` is called while in parallel mode,
+the jobs are executed sequentially by the current thread.
+
+Exceptions
+==========
+If one of the jobs throws an exception, no more jobs are started,
+and the first exception thrown is re-thrown by ``thread_pool_run``
+(in the calling thread) once all the running jobs are done.
+
+free_thread_pool
+****************
+This routine waits for all the threads in the pool to exit and
+frees the corresponding memory.
+This must be called in sequential mode.
+
+{xrst_toc_hidden
+   example/devel/utility/thread_pool_xam.cpp
+}
+Example
+*******
+The file :ref:`thread_pool_xam.cpp-name` contains an example and test of
+using the thread pool.
+
+{xrst_end thread_pool}
+-----------------------------------------------------------------------------
+*/
+# include <cassert>
+# include <atomic>
+# include <thread>
+# include <mutex>
+# include <condition_variable>
+# include <exception>
+# include <vector>
+# include <cppad/utility/thread_alloc.hpp>
+# include <dismod_at/thread_pool.hpp>
+# include <dismod_at/configure.hpp>
+
+namespace {
+   // The pool state is allocated by new_thread_pool and deleted by
+   // free_thread_pool. It is not a static object so that a call to exit,
+   // while the worker threads are waiting, does not destroy it.
+   struct pool_state {
+      // number of threads including the master thread
+      size_t                               n_thread;
+      // worker threads (does not include the master thread)
+      std::vector<std::thread>             worker;
+      // protects all the fields below that are not atomic
+      std::mutex                           mutex;
+      // signals workers that a new run has started (or shutdown)
+      std::condition_variable              start_cv;
+      // signals master that all the workers are done with current run
+      std::condition_variable              done_cv;
+      // incremented each time a run starts
+      size_t                               generation;
+      // number of workers that have not finished the current run
+      size_t                               n_busy;
+      // set true when the workers should exit
+      bool                                 shutdown;
+      // information for the current run
+      size_t                               n_job;
+      const std::function<void(size_t)>*   job;
+      std::atomic<size_t>                  next_job;
+      std::exception_ptr                   exception;
+   };
+   pool_state*           pool_ = DISMOD_AT_NULL_PTR;
+   //
+   // true while thread_pool_run is executing jobs in parallel
+   std::atomic<bool>     in_parallel_(false);
+   //
+   // index of the current thread
+   thread_local size_t   thread_num_ = 0;
+   //
+   // functions used by CppAD::thread_alloc
+   bool in_parallel(void)
+   {  return in_parallel_; }
+   size_t thread_num(void)
+   {  return thread_num_; }
+   //
+   // execute jobs until there are none left in the current run
+   void do_jobs(pool_state* pool)
+   {  size_t job_index = pool->next_job++;
+      while( job_index < pool->n_job )
+      {  try
+         {  (*pool->job)(job_index);
+         }
+         catch(...)
+         {  std::lock_guard<std::mutex> lock(pool->mutex);
+            if( ! pool->exception )
+               pool->exception = std::current_exception();
+            // do not start any more jobs
+            pool->next_job = pool->n_job;
+         }
+         job_index = pool->next_job++;
+      }
+   }
+   //
+   // function executed by each worker thread
+   void worker(pool_state* pool, size_t thread)
+   {  thread_num_        = thread;
+      size_t generation  = 0;
+      while( true )
+      {  {  std::unique_lock<std::mutex> lock(pool->mutex);
+            pool->start_cv.wait(lock, [pool, generation]
+               {  return pool->shutdown || pool->generation != generation; }
+            );
+            if( pool->shutdown )
+               return;
+            generation = pool->generation;
+         }
+         do_jobs(pool);
+         {  std::lock_guard<std::mutex> lock(pool->mutex);
+            assert( pool->n_busy > 0 );
+            --pool->n_busy;
+            if( pool->n_busy == 0 )
+               pool->done_cv.notify_one();
+         }
+      }
+   }
+}
+
+namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
+
+void new_thread_pool(size_t n_thread)
+{  assert( pool_ == DISMOD_AT_NULL_PTR );
+   assert( ! in_parallel_ );
+   assert( 0 < n_thread && n_thread <= CPPAD_MAX_NUM_THREADS );
+   //
+   pool_             = new pool_state;
+   pool_->n_thread   = n_thread;
+   pool_->generation = 0;
+   pool_->n_busy     = 0;
+   pool_->shutdown   = false;
+   pool_->n_job      = 0;
+   pool_->job        = DISMOD_AT_NULL_PTR;
+   pool_->next_job   = 0;
+   if( n_thread == 1 )
+      return;
+   //
+   // inform CppAD memory allocator (must be done in sequential mode)
+   CppAD::thread_alloc::parallel_setup(n_thread, in_parallel, thread_num);
+   CppAD::thread_alloc::hold_memory(true);
+   //
+   // start the workers
+   for(size_t thread = 1; thread < n_thread; ++thread)
+      pool_->worker.push_back( std::thread(worker, pool_, thread) );
+}
+size_t thread_pool_size(void)
+{  if( pool_ == DISMOD_AT_NULL_PTR )
+      return 1;
+   return pool_->n_thread;
+}
+size_t thread_pool_num(void)
+{  return thread_num_; }
+bool thread_pool_in_parallel(void)
+{  return in_parallel_; }
+void thread_pool_run(
+   size_t                              n_job ,
+   const std::function<void(size_t)>&  job   )
+{  // sequential case
+   bool sequential = pool_ == DISMOD_AT_NULL_PTR;
+   sequential     |= in_parallel_;
+   sequential     |= n_job < 2;
+   if( ! sequential )
+      sequential = pool_->n_thread == 1;
+   if( sequential )
+   {  for(size_t job_index = 0; job_index < n_job; ++job_index)
+         job(job_index);
+      return;
+   }
+   //
+   // start this run
+   {  std::lock_guard<std::mutex> lock(pool_->mutex);
+      pool_->n_job     = n_job;
+      pool_->job       = &job;
+      pool_->next_job  = 0;
+      pool_->exception = std::exception_ptr();
+      pool_->n_busy    = pool_->n_thread - 1;
+      in_parallel_     = true;
+      ++pool_->generation;
+   }
+   pool_->start_cv.notify_all();
+   //
+   // master thread also executes jobs
+   do_jobs(pool_);
+   //
+   // wait for the workers to finish
+   std::exception_ptr exception;
+   {  std::unique_lock<std::mutex> lock(pool_->mutex);
+      pool_->done_cv.wait(lock, []{ return pool_->n_busy == 0; } );
+      in_parallel_     = false;
+      pool_->job       = DISMOD_AT_NULL_PTR;
+      exception        = pool_->exception;
+      pool_->exception = std::exception_ptr();
+   }
+   if( exception )
+      std::rethrow_exception(exception);
+   return;
+}
+void free_thread_pool(void)
+{  assert( ! in_parallel_ );
+   if( pool_ == DISMOD_AT_NULL_PTR )
+      return;
+   size_t n_thread = pool_->n_thread;
+   {  std::lock_guard<std::mutex> lock(pool_->mutex);
+      pool_->shutdown = true;
+   }
+   pool_->start_cv.notify_all();
+   for(size_t i = 0; i < pool_->worker.size(); ++i)
+      pool_->worker[i].join();
+   delete pool_;
+   pool_ = DISMOD_AT_NULL_PTR;
+   if( n_thread == 1 )
+      return;
+   //
+   // return CppAD memory allocator to single thread mode
+   CppAD::thread_alloc::hold_memory(false);
+   for(size_t thread = 1; thread < n_thread; ++thread)
+      CppAD::thread_alloc::free_available(thread);
+   CppAD::thread_alloc::parallel_setup(1, DISMOD_AT_NULL_PTR, DISMOD_AT_NULL_PTR);
+}
+
+} // END_DISMOD_AT_NAMESPACE
@@ -2,6 +2,7 @@
 // SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
 // SPDX-FileContributor: 2014-22 Bradley M. Bell
 // ----------------------------------------------------------------------------
+# include <algorithm>
 # include <dismod_at/time_line_vec.hpp>
 # include <dismod_at/a1_double.hpp>
 
@@ -22,10 +23,14 @@ Syntax
 | *extend_grid* = *vec* . ``extend_grid`` ()
 | *sub_lower* = *vec* . ``sub_lower`` ()
 | *sub_upper* = *vec* . ``sub_upper`` ()
+| *vec* . ``reserve`` ( *n_time* )
 | *vec* . ``add_point`` ( *age_index* , *point* )
+| *vec* . ``append_point`` ( *age_index* , *point* )
+| *vec* . ``merge`` ()
 | *time_line* = *vec* . ``time_line`` ( *age_index* )
 | *time_diff* = *vec* . ``max_time_diff`` ( *age_index* , *time_index* )
 | *avg* = *vec* . ``age_time_avg`` ()
+| *coef* = *vec* . ``age_time_coef`` ()
 
 Float
 *****
@@ -67,6 +72,8 @@ the specified lower and upper ages and times where
 
 There is a time line for each sub grid point
 and it is initialized as empty.
+The memory used by the time lines for a previous call to ``specialize``
+is re-used (not re-allocated) when possible.
 
 extend_grid
 ***********
@@ -88,6 +95,14 @@ where the sub grid ends;
 
    ``true`` == ``near_equal`` ( *age_upper* , *extend_grid* [ *sub_upper*  ] )
 
+reserve
+*******
+This ensures that every time line has memory for at least *n_time*
+points, so that adding points to a line does not allocate memory
+until it has more than *n_time* points.
+It must be called after ``specialize`` and before any points are added.
+The memory is kept by later calls to ``specialize`` .
+
 age_index
 *********
 This is the index, for the time line, in the extended age grid
@@ -113,6 +128,27 @@ The time must satisfy
 
 In addition, two calls to ``add_point`` cannot have the
 same *age_index* and *point* . ``time`` .
+The point is inserted in the time line so that it remains sorted.
+This requires shifting the points that come after it and is
+faster when the points for each *age_index* are added in increasing order.
+
+append_point
+************
+This has the same effect as ``add_point`` except that the point is
+placed at the end of the time line and the time line may not be sorted.
+This takes constant time per point.
+It is used to add many points and then sort them all at once using
+``merge`` .
+
+merge
+*****
+This sorts the points in each time line that were added using
+``append_point`` and merges them with the points that were already sorted.
+If there are *n* points in a time line and *m* were added by
+``append_point`` , this takes order *n* + *m* log( *m* ) operations.
+There must be a call to ``merge`` after ``append_point`` ,
+and before any of the other member functions that access the time lines
+(including ``add_point`` ) are used.
 
 time_line
 *********
@@ -163,6 +199,21 @@ must have a point with time nearly equal to
 *time_lower* and a point with time nearly equal to *time_upper* .
 If the upper and lower time limits are nearly equal,
 only one call to ``add_point`` for each time line is necessary.
+
+age_time_coef
+*************
+The average computed by ``age_time_avg`` is a linear function
+of the point values and this function returns the coefficients.
+To be specific, the return value *coef* has one element for each point
+in the time lines and
+
+   *avg* = *coef* [0] * *v* [0] + *coef* [1] * *v* [1] + ...
+
+where *v* [ *m* ] is the value for the *m*-th point when the points
+are ordered by *age_index* and then by time in each time line.
+The coefficients do not depend on the point values.
+Hence they can be computed once and used to compute the average
+for many different values.
 {xrst_toc_hidden
    example/devel/utility/time_line_vec_xam.cpp
 }
@@ -201,6 +252,18 @@ Prototype
    // BEGIN_SUB_UPPER_PROTOTYPE
    // END_SUB_UPPER_PROTOTYPE
 }
+{xrst_literal
+   // BEGIN_RESERVE_PROTOTYPE
+   // END_RESERVE_PROTOTYPE
+}
+{xrst_literal
+   // BEGIN_APPEND_POINT_PROTOTYPE
+   // END_APPEND_POINT_PROTOTYPE
+}
+{xrst_literal
+   // BEGIN_MERGE_PROTOTYPE
+   // END_MERGE_PROTOTYPE
+}
 {xrst_literal
    // BEGIN_TIME_LINE_PROTOTYPE
    // END_TIME_LINE_PROTOTYPE
@@ -213,6 +276,10 @@ Prototype
    // BEGIN_AGE_TIME_AVG_PROTOTYPE
    // END_AGE_TIME_AVG_PROTOTYPE
 }
+{xrst_literal
+   // BEGIN_AGE_TIME_COEF_PROTOTYPE
+   // END_AGE_TIME_COEF_PROTOTYPE
+}
 
 {xrst_end time_line_vec}
 */
@@ -315,8 +382,11 @@ void time_line_vec<Float>::specialize(
    // vec_
    size_t n_sub = sub_upper_ - sub_lower_ + 1;
    vec_.resize(n_sub);
+   n_sorted_.resize(n_sub);
    for(size_t j = 0; j < n_sub; ++j)
-      vec_[j].resize(0);
+   {  vec_[j].resize(0);
+      n_sorted_[j] = 0;
+   }
 }
 // ---------------------------------------------------------------------------
 // BEGIN_EXTEND_GRID_PROTOTYPE
@@ -339,7 +409,21 @@ size_t time_line_vec<Float>::sub_upper(void) const
 // END_SUB_UPPER_PROTOTYPE
 {  return sub_upper_; }
 
-
+// ---------------------------------------------------------------------------
+// BEGIN_RESERVE_PROTOTYPE
+template <class Float>
+void time_line_vec<Float>::reserve(size_t n_time)
+// END_RESERVE_PROTOTYPE
+{  size_t n_sub = sub_upper_ - sub_lower_ + 1;
+   for(size_t j = 0; j < n_sub; ++j)
+   {  assert( vec_[j].size() == 0 );
+      // resize to zero does not free memory
+      if( vec_[j].capacity() < n_time )
+      {  vec_[j].resize(n_time);
+         vec_[j].resize(0);
+      }
+   }
+}
 // ---------------------------------------------------------------------------
 // BEGIN_ADD_POINT_PROTOTYPE
 template <class Float>
@@ -355,18 +439,24 @@ void time_line_vec<Float>::add_point(
    // this time line
    CppAD::vector<time_point>& time_line = vec_[age_index - sub_lower_];
    size_t n_time = time_line.size();
-   //
-   // time index at which to insert this point
-   size_t time_index = 0;
-   while( time_index < n_time && time_line[time_index].time < point.time )
-      ++time_index;
+   assert( n_sorted_[age_index - sub_lower_] == n_time );
    //
    // case where this point goes at the end of the line
-   if( time_index == n_time )
+   if( n_time == 0 || time_line[n_time - 1].time < point.time )
    {  time_line.push_back(point);
+      ++n_sorted_[age_index - sub_lower_];
       return;
    }
    //
+   // time index at which to insert this point
+   const time_point* begin = time_line.data();
+   size_t time_index       = size_t( std::lower_bound(
+      begin, begin + n_time, point,
+      [](const time_point& left, const time_point& right)
+      {  return left.time < right.time; }
+   ) - begin );
+   assert( time_index < n_time );
+   //
    // make sure two calls do not have the same time
    assert( ! near_equal( point.time, time_line[time_index].time ) );
    //
@@ -375,9 +465,62 @@ void time_line_vec<Float>::add_point(
    for(size_t i = n_time - 1; i > time_index; --i)
       time_line[i] = time_line[i-1];
    time_line[time_index] = point;
+   ++n_sorted_[age_index - sub_lower_];
    //
    return;
 }
+// ---------------------------------------------------------------------------
+// BEGIN_APPEND_POINT_PROTOTYPE
+template <class Float>
+void time_line_vec<Float>::append_point(
+   const size_t&     age_index ,
+   const time_point& point     )
+// END_APPEND_POINT_PROTOTYPE
+{  assert( time_lower_ <= point.time || near_equal(time_lower_, point.time) );
+   assert( point.time <= time_upper_ || near_equal(time_upper_, point.time) );
+   assert( sub_lower_ <= age_index );
+   assert( age_index <= sub_upper_ );
+   //
+   // this time line
+   CppAD::vector<time_point>& time_line = vec_[age_index - sub_lower_];
+   size_t n_time = time_line.size();
+   //
+   // the line stays sorted if this point goes at the end
+   bool sorted = n_sorted_[age_index - sub_lower_] == n_time;
+   sorted     &= n_time == 0 || time_line[n_time - 1].time < point.time;
+   time_line.push_back(point);
+   if( sorted )
+      ++n_sorted_[age_index - sub_lower_];
+   //
+   return;
+}
+// ---------------------------------------------------------------------------
+// BEGIN_MERGE_PROTOTYPE
+template <class Float>
+void time_line_vec<Float>::merge(void)
+// END_MERGE_PROTOTYPE
+{  size_t n_sub = sub_upper_ - sub_lower_ + 1;
+   auto less = [](const time_point& left, const time_point& right)
+   {  return left.time < right.time; };
+   for(size_t i = 0; i < n_sub; ++i)
+   {  CppAD::vector<time_point>& time_line = vec_[i];
+      size_t n_time   = time_line.size();
+      size_t n_sorted = n_sorted_[i];
+      if( n_sorted < n_time )
+      {  time_point* begin  = time_line.data();
+         time_point* middle = begin + n_sorted;
+         time_point* end    = begin + n_time;
+         std::sort(middle, end, less);
+         std::inplace_merge(begin, middle, end, less);
+         n_sorted_[i] = n_time;
+      }
+# ifndef NDEBUG
+      // make sure two points do not have the same time
+      for(size_t j = 1; j < n_time; ++j)
+         assert( ! near_equal( time_line[j-1].time, time_line[j].time ) );
+# endif
+   }
+}
 
 // ---------------------------------------------------------------------------
 // BEGIN_TIME_LINE_PROTOTYPE
@@ -388,7 +531,9 @@ time_line_vec<Float>::time_line(const size_t& age_index) const
 {
    assert( sub_lower_ <= age_index );
    assert( age_index <= sub_upper_ );
-   return vec_[age_index - sub_lower_];
+   size_t i = age_index - sub_lower_;
+   assert( n_sorted_[i] == vec_[i].size() );
+   return vec_[i];
 }
 // ---------------------------------------------------------------------------
 // BEGIN_MAX_TIME_DIFF_PROTOTYPE
@@ -402,6 +547,7 @@ double time_line_vec<Float>::max_time_diff(
    for(size_t i = 0; i < n_sub; ++i)
    {  const CppAD::vector<time_point>& time_line = vec_[i];
       size_t n_time = time_line.size();
+      assert( n_sorted_[i] == n_time );
       if( n_time > 1 )
       {  for(size_t j = 1; j < n_time; ++j)
          {  double diff = time_line[j].time - time_line[j-1].time;
@@ -430,6 +576,7 @@ Float time_line_vec<Float>::age_time_avg(void) const
    {  const CppAD::vector<time_point>& line( vec_[i] );
       size_t n_time = line.size();
       //
+      assert( n_sorted_[i] == n_time );
       assert( n_time >= 1 );
       assert( near_equal( line[0].time, time_lower_ ) );
       assert( near_equal( line[n_time - 1].time, time_upper_ ) );
@@ -474,6 +621,84 @@ Float time_line_vec<Float>::age_time_avg(void) const
    }
    return result;
 }
+// ---------------------------------------------------------------------------
+// BEGIN_AGE_TIME_COEF_PROTOTYPE
+template <class Float>
+CppAD::vector<double> time_line_vec<Float>::age_time_coef(void) const
+// END_AGE_TIME_COEF_PROTOTYPE
+{  size_t n_sub = sub_upper_ - sub_lower_ + 1;
+   //
+   // n_point
+   size_t n_point = 0;
+   for(size_t i = 0; i < n_sub; ++i)
+      n_point += vec_[i].size();
+   //
+   // coefficient for each point in the weighted sum w.r.t time
+   CppAD::vector<double> coef(n_point);
+   CppAD::vector<double> sum_w(n_sub);
+   size_t m = 0;
+   for(size_t i = 0; i < n_sub; ++i)
+   {  const CppAD::vector<time_point>& line( vec_[i] );
+      size_t n_time = line.size();
+      //
+      assert( n_sorted_[i] == n_time );
+      assert( n_time >= 1 );
+      assert( near_equal( line[0].time, time_lower_ ) );
+      assert( near_equal( line[n_time - 1].time, time_upper_ ) );
+      //
+      if( n_time == 1 )
+      {  sum_w[i] = line[0].weight;
+         coef[m]  = line[0].weight;
+      }
+      else
+      {  sum_w[i] = 0.0;
+         for(size_t j = 0; j < n_time; ++j)
+            coef[m + j] = 0.0;
+         for(size_t j = 1; j < n_time; ++j )
+         {  double t_m = line[j-1].time;
+            double w_m = line[j-1].weight;
+            //
+            double t_j = line[j].time;
+            double w_j = line[j].weight;
+            //
+            sum_w[i]       += (t_j - t_m) * (w_j + w_m) / 2.0;
+            coef[m + j - 1] += (t_j - t_m) * w_m / 2.0;
+            coef[m + j]     += (t_j - t_m) * w_j / 2.0;
+         }
+      }
+      m += n_time;
+   }
+   //
+   // coefficient for each age in the weighted sum w.r.t. age
+   CppAD::vector<double> age_coef(n_sub);
+   if( n_sub == 1 )
+      age_coef[0] = 1.0 / sum_w[0];
+   else
+   {  double weight(0);
+      for(size_t i = 0; i < n_sub; ++i)
+         age_coef[i] = 0.0;
+      for(size_t i = 1; i < n_sub; ++i)
+      {  double w   = (sum_w[i] + sum_w[i-1]) / 2.0;
+         size_t k   = i + sub_lower_;
+         double da  = extend_grid_[k] - extend_grid_[k-1];
+         weight        += w * da;
+         age_coef[i]   += da / 2.0;
+         age_coef[i-1] += da / 2.0;
+      }
+      for(size_t i = 0; i < n_sub; ++i)
+         age_coef[i] /= weight;
+   }
+   //
+   // coef
+   m = 0;
+   for(size_t i = 0; i < n_sub; ++i)
+   {  size_t n_time = vec_[i].size();
+      for(size_t j = 0; j < n_time; ++j)
+         coef[m + j] *= age_coef[i];
+      m += n_time;
+   }
+   return coef;
+}
 
 
 // instantiation
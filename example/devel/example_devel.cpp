@@ -57,8 +57,10 @@ extern bool bilinear_interp_xam(void);
 extern bool child_info_xam(void);
 extern bool child_data_in_fit_xam(void);
 extern bool cohort_ode_xam(void);
+extern bool counter_rng_xam(void);
 extern bool subset_data_xam(void);
 extern bool eigen_ode2_xam(void);
+extern bool ode2_chkpoint_xam(void);
 extern bool trap_ode2_xam(void);
 extern bool fixed_effect_xam(void);
 extern bool manage_gsl_rng_xam(void);
@@ -71,6 +73,7 @@ extern bool residual_density_xam(void);
 extern bool sim_random_xam(void);
 extern bool grid2line_xam(void);
 extern bool split_space_xam(void);
+extern bool thread_pool_xam(void);
 extern bool time_line_vec_xam(void);
 
 // table subdirectory
@@ -103,6 +106,7 @@ extern bool get_weight_grid_xam(void);
 extern bool get_subgroup_table_xam(void);
 extern bool put_table_row_xam(void);
 extern bool smooth_info_xam(void);
+extern bool table_writer_xam(void);
 extern bool weight_info_xam(void);
 
 // anonymous namespace
@@ -156,8 +160,10 @@ int main(void)
    RUN(child_info_xam);
    RUN(child_data_in_fit_xam);
    RUN(cohort_ode_xam);
+   RUN(counter_rng_xam);
    RUN(subset_data_xam);
    RUN(eigen_ode2_xam);
+   RUN(ode2_chkpoint_xam);
    RUN(trap_ode2_xam);
    RUN(fixed_effect_xam);
    RUN(manage_gsl_rng_xam);
@@ -170,6 +176,7 @@ int main(void)
    RUN(sim_random_xam);
    RUN(grid2line_xam);
    RUN(split_space_xam);
+   RUN(thread_pool_xam);
    RUN(time_line_vec_xam);
 
    // table subdirectory
@@ -202,6 +209,7 @@ int main(void)
    RUN(get_subgroup_table_xam);
    RUN(put_table_row_xam);
    RUN(smooth_info_xam);
+   RUN(table_writer_xam);
    RUN(weight_info_xam);
 
    // summary report
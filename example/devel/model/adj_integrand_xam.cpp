@@ -32,6 +32,9 @@ bool adj_integrand_xam(void)
    // rate_case
    std::string rate_case = "iota_pos_rho_zero";
    //
+   // ode_tolerance
+   double ode_tolerance = 0.0;
+   //
    // age_table
    size_t n_age_table = 6;
    double age_min     = 20.0;
@@ -200,6 +203,7 @@ bool adj_integrand_xam(void)
       cov2weight_obj,
       w_info_vec,
       rate_case,
+      ode_tolerance,
       age_table,
       time_table,
       covariate_table,
@@ -209,6 +213,7 @@ bool adj_integrand_xam(void)
       s_info_vec,
       pack_object
    );
+   dismod_at::adj_integrand::work_struct work;
    size_t subgroup_id = 0;
    size_t node_id     = 0;
    vector<Float> adj_line = adjint_obj.line(
@@ -220,7 +225,8 @@ bool adj_integrand_xam(void)
       child,
       subgroup_id,
       x,
-      pack_vec
+      pack_vec,
+      work
    );
    //
    // check result
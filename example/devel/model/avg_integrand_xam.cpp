@@ -31,6 +31,9 @@ bool avg_integrand_xam(void)
    // rate_case
    std::string rate_case = "iota_pos_rho_zero";
    //
+   // ode_tolerance
+   double ode_tolerance = 0.0;
+   //
    // age_table
    size_t n_age_table = 6;
    double age_ini     = 20.0;
@@ -209,9 +212,9 @@ bool avg_integrand_xam(void)
       cov2weight_obj,
       ode_step_size,
       rate_case,
+      ode_tolerance,
       age_table,
       time_table,
-      age_avg_grid,
       covariate_table,
       subgroup_table,
       integrand_table,
@@ -220,6 +223,9 @@ bool avg_integrand_xam(void)
       s_info_vec,
       pack_object
    );
+   // work
+   dismod_at::avg_integrand::work_struct work(age_avg_grid);
+   //
    double age_lower    = age_ini + 10.0;
    double age_upper    = age_end - 10.0;
    double time_lower   = 2000.0;
@@ -242,14 +248,17 @@ bool avg_integrand_xam(void)
       child,
       subgroup_id,
       x,
-      pack_vec
+      pack_vec,
+      work
    );
    // check result
    double eps99 = 99.0 * std::numeric_limits<double>::epsilon();
    ok          &= CppAD::NearEqual(avg, beta, eps99, eps99);
    // -----------------------------------------------------------------------
    // susceptible
-   integrand_id = 1;
+   // (turn on the cohort cache for this value of pack_vec)
+   integrand_id      = 1;
+   work.pack_version = 1;
    avg = avgint_obj.rectangle(
       node_id,
       age_lower,
@@ -262,7 +271,8 @@ bool avg_integrand_xam(void)
       child,
       subgroup_id,
       x,
-      pack_vec
+      pack_vec,
+      work
    );
    //
    // check result
@@ -273,6 +283,83 @@ bool avg_integrand_xam(void)
    double check   = (up_int - low_int) / (age_upper - age_lower );
    ok            &= CppAD::NearEqual(avg, check, 1e-2, 1e-2);
    //
+   // The susceptible cohorts are now in the cache, so computing
+   // the same average again does not require solving the ODE.
+   ok &= work.cohort_cache.size() > 0;
+   Float avg_cache = avgint_obj.rectangle(
+      node_id,
+      age_lower,
+      age_upper,
+      time_lower,
+      time_upper,
+      weight_id,
+      integrand_id,
+      n_child,
+      child,
+      subgroup_id,
+      x,
+      pack_vec,
+      work
+   );
+   ok &= avg_cache == avg;
+   //
+   // a new version of pack_vec clears the cache
+   work.pack_version = 2;
+   avg_cache = avgint_obj.rectangle(
+      node_id,
+      age_lower,
+      age_upper,
+      time_lower,
+      time_upper,
+      weight_id,
+      integrand_id,
+      n_child,
+      child,
+      subgroup_id,
+      x,
+      pack_vec,
+      work
+   );
+   ok &= work.cache_version == 2;
+   ok &= avg_cache == avg;
+   //
+   // The cohorts for a smaller upper time start with the same ages as the
+   // cohorts in the cache, so they use the cache.
+   // Check that the result is the same as without the cache.
+   double time_mid = (time_lower + time_upper) / 2.0;
+   avg_cache = avgint_obj.rectangle(
+      node_id,
+      age_lower,
+      age_upper,
+      time_lower,
+      time_mid,
+      weight_id,
+      integrand_id,
+      n_child,
+      child,
+      subgroup_id,
+      x,
+      pack_vec,
+      work
+   );
+   work.pack_version = 0;
+   avg = avgint_obj.rectangle(
+      node_id,
+      age_lower,
+      age_upper,
+      time_lower,
+      time_mid,
+      weight_id,
+      integrand_id,
+      n_child,
+      child,
+      subgroup_id,
+      x,
+      pack_vec,
+      work
+   );
+   ok &= avg_cache == avg;
+   //
    return ok;
 }
 // END C++
@@ -196,7 +196,6 @@ bool avg_noise_effect_xam(void)
    );
    dismod_at::avg_noise_effect avg_noise_obj(
       ode_step_size,
-      age_avg_grid,
       age_table,
       time_table,
       subgroup_table,
@@ -205,6 +204,8 @@ bool avg_noise_effect_xam(void)
       s_info_vec,
       pack_object
    );
+   dismod_at::avg_noise_effect::work_struct work(age_avg_grid);
+   //
    // x
    vector<double> x(1);
    x[0] = x_j;
@@ -241,7 +242,8 @@ bool avg_noise_effect_xam(void)
       subgroup_id,
       integrand_id,
       x,
-      pack_vec
+      pack_vec,
+      work
    );
    //
    // average std mulcov
@@ -388,6 +388,7 @@ bool fit_model_xam(void)
    bool        fit_simulated_data = false;
    std::string meas_noise_effect = "add_std_scale_all";
    std::string rate_case       = "iota_pos_rho_pos";
+   double      ode_tolerance   = 0.0;
    std::string age_avg_split   = "";
    vector<double> age_avg_grid = dismod_at::age_avg_grid(
       ode_step_size, age_avg_split, age_table
@@ -398,6 +399,7 @@ bool fit_model_xam(void)
       fit_simulated_data,
       meas_noise_effect,
       rate_case,
+      ode_tolerance,
       bound_random,
       ode_step_size,
       age_avg_grid,
@@ -165,6 +165,8 @@ bool like_all_xam(void)
    vector<double> data_cov_value(data_table.size() * n_covariate);
    //
    // parent node, time and age integrantion.
+   // The two data points only differ by density, so like_all computes
+   // the average integrand once and uses it for both residuals.
    for(size_t data_id = 0; data_id < 2; data_id++)
    {
       data_table[data_id].integrand_id =  int( dismod_at::mtother_enum );
@@ -261,6 +263,7 @@ bool like_all_xam(void)
    bool        fit_simulated_data = false;
    std::string meas_noise_effect = "add_std_scale_all";
    std::string rate_case       = "iota_pos_rho_pos";
+   double      ode_tolerance   = 0.0;
    std::string age_avg_split   = "";
    vector<double> age_avg_grid = dismod_at::age_avg_grid(
       ode_step_size, age_avg_split, age_table
@@ -271,6 +274,7 @@ bool like_all_xam(void)
       fit_simulated_data,
       meas_noise_effect,
       rate_case,
+      ode_tolerance,
       bound_random,
       ode_step_size,
       age_avg_grid,
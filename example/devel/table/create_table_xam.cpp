@@ -16,10 +16,14 @@ C++ create_table: Example and Test
 {xrst_end create_table_xam.cpp}
 */
 // BEGIN C++
+# include <cmath>
+# include <limits>
 # include <dismod_at/create_table.hpp>
 # include <dismod_at/exec_sql_cmd.hpp>
 # include <dismod_at/open_connection.hpp>
 # include <dismod_at/get_covariate_table.hpp>
+# include <dismod_at/get_table_column.hpp>
+# include <dismod_at/null_int.hpp>
 
 bool create_table_xam(void)
 {
@@ -79,6 +83,64 @@ bool create_table_xam(void)
    ok  &= covariate_table[1].covariate_name == "weight";
    ok  &= covariate_table[1].reference      == 100.;
    ok  &= covariate_table[1].max_difference == 200;
+   // ----------------------------------------------------------------------
+   // create a table using columns of integer and real values
+   n_col      = 3;
+   n_row      = 3;
+   table_name = "column_table";
+   col_name.resize(n_col);
+   col_type.resize(n_col);
+   col_unique.resize(n_col);
+   //
+   col_name[0]     = "sample_index";
+   col_type[0]     = "integer";
+   col_unique[0]   = false;
+   //
+   col_name[1]     = "sample_value";
+   col_type[1]     = "real";
+   col_unique[1]   = false;
+   //
+   col_name[2]     = "var_id";
+   col_type[2]     = "integer";
+   col_unique[2]   = false;
+   //
+   // int_value: first integer column followed by second integer column
+   vector<int>    int_value(2 * n_row);
+   vector<double> real_value(n_row);
+   for(i = 0; i < n_row; ++i)
+   {  int_value[0 * n_row + i] = int(i);
+      int_value[1 * n_row + i] = int(10 * i);
+      real_value[i]            = double(i) + 0.5;
+   }
+   // null values
+   int_value[1 * n_row + 2] = DISMOD_AT_NULL_INT;
+   real_value[1]            = std::numeric_limits<double>::quiet_NaN();
+   //
+   dismod_at::create_table(
+      db, table_name, col_name, col_type, col_unique,
+      n_row, int_value, real_value
+   );
+   //
+   // check the table
+   vector<int>    sample_index, var_id;
+   vector<double> sample_value;
+   dismod_at::get_table_column(db, table_name, "sample_index", sample_index);
+   dismod_at::get_table_column(db, table_name, "sample_value", sample_value);
+   dismod_at::get_table_column(db, table_name, "var_id", var_id);
+   ok &= sample_index.size() == n_row;
+   ok &= sample_value.size() == n_row;
+   ok &= var_id.size() == n_row;
+   for(i = 0; i < n_row; ++i)
+   {  ok &= sample_index[i] == int(i);
+      if( i == 1 )
+         ok &= std::isnan( sample_value[i] );
+      else
+         ok &= sample_value[i] == double(i) + 0.5;
+      if( i == 2 )
+         ok &= var_id[i] == DISMOD_AT_NULL_INT;
+      else
+         ok &= var_id[i] == int(10 * i);
+   }
    //
    // close database and return
    sqlite3_close(db);
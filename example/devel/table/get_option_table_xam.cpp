@@ -53,7 +53,9 @@ bool get_option_table_xam(void)
       "limited_memory_max_history_fixed", "15",
       "max_num_iter_random",              "50",
       "method_random",                    "ipopt_random",
+      "n_thread",                         "2",
       "ode_step_size",                    "20.0",
+      "ode_tolerance",                    "1e-6",
       "other_database",                   "",
       "other_input_table",                "",
       "parent_node_id",                   "1",
@@ -63,9 +65,11 @@ bool get_option_table_xam(void)
       "quasi_fixed",                      "false",
       "random_seed",                      "123",
       "rate_case",                        "iota_zero_rho_zero",
+      "save_fit_hes",                     "true",
       "splitting_covariate",              "",
       "tolerance_fixed",                  "1e-7",
       "tolerance_random",                 "1e-7",
+      "trace_db_input",                   "true",
       "trace_init_fit_model",             "false",
       "warn_on_stderr",                   "true",
       "zero_sum_child_rate",              "iota  omega",
@@ -87,6 +87,30 @@ bool get_table_column_xam(void)
    ok &= real_result[0] == 0.0;
    ok &= real_result[1] == 1.0;
 
+   // read all the columns in one pass
+   CppAD::vector<string> col_name(3), col_type(3);
+   col_name[0] = "mytable_real";
+   col_type[0] = "real";
+   col_name[1] = "mytable_id";
+   col_type[1] = "integer";
+   col_name[2] = "mytable_text";
+   col_type[2] = "text";
+   CppAD::vector<int>    int_value;
+   CppAD::vector<double> real_value;
+   CppAD::vector<string> text_value;
+   size_t n_row = dismod_at::get_table_column(
+      db, table_name, col_name, col_type, int_value, real_value, text_value
+   );
+   ok &= n_row == 2;
+   ok &= int_value.size()  == n_row;
+   ok &= real_value.size() == n_row;
+   ok &= text_value.size() == n_row;
+   for(size_t i = 0; i < n_row; ++i)
+   {  ok &= int_value[i]  == int_result[i];
+      ok &= real_value[i] == real_result[i];
+      ok &= text_value[i] == text_result[i];
+   }
+
    // check return value when column does not exist
    column_name = "bad_column_name";
    column_type = dismod_at::get_table_column_type(
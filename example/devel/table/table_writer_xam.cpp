@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-23 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin table_writer_xam.cpp dev}
+
+C++ table_writer: Example and Test
+##################################
+
+{xrst_literal
+   // BEGIN C++
+   // END C++
+}
+
+{xrst_end table_writer_xam.cpp}
+*/
+// BEGIN C++
+# include <dismod_at/table_writer.hpp>
+# include <dismod_at/open_connection.hpp>
+# include <dismod_at/get_table_column.hpp>
+# include <cppad/utility/to_string.hpp>
+# include <dismod_at/null_int.hpp>
+
+bool table_writer_xam(void)
+{
+   bool   ok = true;
+   using  std::string;
+   using  CppAD::vector;
+
+   string   file_name = "example.db";
+   bool     new_file  = true;
+   sqlite3* db        = dismod_at::open_connection(file_name, new_file);
+
+   // ----------------------------------------------------------------------
+   // column information
+   size_t n_col = 3;
+   vector<string> col_name(n_col), col_type(n_col);
+   vector<bool>   col_unique(n_col);
+   //
+   col_name[0]     = "name";
+   col_type[0]     = "text";
+   col_unique[0]   = false;
+   //
+   col_name[1]     = "row_index";
+   col_type[1]     = "integer";
+   col_unique[1]   = false;
+   //
+   col_name[2]     = "row_value";
+   col_type[2]     = "real";
+   col_unique[2]   = false;
+   //
+   // write the table with a commit every 2 rows
+   size_t n_row      = 5;
+   size_t n_commit   = 2;
+   string table_name = "my_table";
+   dismod_at::table_writer writer(
+      db, table_name, col_name, col_type, col_unique, n_commit
+   );
+   for(size_t i = 0; i < n_row; ++i)
+   {  writer.set_text(0, "row_" + CppAD::to_string(i) );
+      if( i == 0 )
+         writer.set_null(1);
+      else
+         writer.set_integer(1, int(i) );
+      writer.set_real(2, double(i) / 4.0 );
+      writer.next_row();
+   }
+   ok &= writer.n_row() == n_row;
+   writer.close();
+   // ----------------------------------------------------------------------
+   // check the table
+   vector<string> name;
+   dismod_at::get_table_column(db, table_name, "name", name);
+   vector<int> index;
+   dismod_at::get_table_column(db, table_name, "row_index", index);
+   vector<double> value;
+   dismod_at::get_table_column(db, table_name, "row_value", value);
+   //
+   ok &= name.size()  == n_row;
+   ok &= index.size() == n_row;
+   ok &= value.size() == n_row;
+   for(size_t i = 0; i < n_row; ++i)
+   {  ok &= name[i] == "row_" + CppAD::to_string(i);
+      if( i == 0 )
+         ok &= index[i] == DISMOD_AT_NULL_INT;
+      else
+         ok &= index[i] == int(i);
+      ok &= value[i] == double(i) / 4.0;
+   }
+   //
+   // close database and return
+   sqlite3_close(db);
+   return ok;
+}
+// END C++
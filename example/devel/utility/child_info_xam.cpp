@@ -63,6 +63,12 @@ bool child_info_xam(void)
    ok &= child_info4data.table_id2child(2) == 0;      // third  data child_id = 0
    ok &= child_info4data.table_id2child(3) == n_child;// fourth in parent set
 
+   // check node_id2child
+   ok &= child_info4data.node_id2child(0) == n_child; // parent node
+   ok &= child_info4data.node_id2child(1) == 0;       // first child
+   ok &= child_info4data.node_id2child(2) == 1;       // second child
+   ok &= child_info4data.node_id2child(3) == 1;       // grand child
+
    return ok;
 }
 // END C++
@@ -38,6 +38,27 @@ namespace {
          return;
       }
    };
+   // rates that do not commute at different ages
+   void fast_rate(
+      double a, double& iota, double& rho, double& chi, double& omega
+   )
+   {  iota  = 1.0;
+      rho   = 2.0 * a;
+      chi   = 0.1;
+      omega = 0.5 * a;
+   }
+   class Fast {
+   public:
+      void Ode(double a, const vector<double>& y, vector<double>& yp)
+      {  double iota, rho, chi, omega;
+         fast_rate(a, iota, rho, chi, omega);
+         double S      = y[0];
+         double C      = y[1];
+         yp[0]         = - (iota + omega) * S + rho * C;
+         yp[1]         = + iota * S - (rho + chi + omega) * C;
+         return;
+      }
+   };
 }
 
 bool cohort_ode_xam(void)
@@ -60,8 +81,9 @@ bool cohort_ode_xam(void)
    Float  pini   = 0.2;
    vector<Float> s_out(n), c_out(n);
    std::string rate_case = "iota_pos_rho_pos";
+   double ode_tolerance  = 0.0;
    dismod_at::cohort_ode(
-      rate_case, age, pini, iota, rho, chi, omega, s_out, c_out
+      rate_case, ode_tolerance, age, pini, iota, rho, chi, omega, s_out, c_out
    );
    Fun F;
    size_t M = 100;
@@ -79,6 +101,52 @@ bool cohort_ode_xam(void)
    ok &= fabs( 1.0 - s_out[n-1] / yf[0] ) < 1e-10;
    ok &= fabs( 1.0 - c_out[n-1] / yf[1] ) < 1e-10;
    //
+   // same result when rate_case is converted to case_number first
+   size_t case_number = dismod_at::cohort_ode_case_number(rate_case);
+   ok &= case_number == 4;
+   vector<Float> s_num(n), c_num(n);
+   dismod_at::cohort_ode(
+      case_number, ode_tolerance, age, pini, iota, rho, chi, omega,
+      s_num, c_num
+   );
+   for(size_t k = 0; k < n; ++k)
+   {  ok &= s_num[k] == s_out[k];
+      ok &= c_num[k] == c_out[k];
+   }
+   //
+   // Use sub-intervals where the one step error estimate is too large.
+   // This requires double (not a1_double) values for the rates.
+   vector<double> iota_d(n), rho_d(n), chi_d(n), omega_d(n);
+   for(size_t k = 0; k < n; ++k)
+      fast_rate(age[k], iota_d[k], rho_d[k], chi_d[k], omega_d[k]);
+   double pini_d = 0.2;
+   Fast G;
+   vector<double> yi_d(2);
+   yi_d[0] = 1.0 - pini_d;
+   yi_d[1] = pini_d;
+   vector<double> yf_d = CppAD::Runge45(G, M, age[0], age[n-1], yi_d);
+   vector<double> s_d(n), c_d(n);
+   //
+   // one step per interval
+   ode_tolerance = 0.0;
+   dismod_at::cohort_ode(
+      case_number, ode_tolerance, age, pini_d, iota_d, rho_d, chi_d, omega_d,
+      s_d, c_d
+   );
+   ok &= fabs( s_d[n-1] - yf_d[0] ) > 1e-3;
+   ok &= fabs( c_d[n-1] - yf_d[1] ) > 1e-3;
+   //
+   // error controlled steps
+   ode_tolerance = 1e-6;
+   dismod_at::cohort_ode(
+      case_number, ode_tolerance, age, pini_d, iota_d, rho_d, chi_d, omega_d,
+      s_d, c_d
+   );
+   // std::cout << s_d[n-1] - yf_d[0] << "\n";
+   // std::cout << c_d[n-1] - yf_d[1] << "\n";
+   ok &= fabs( s_d[n-1] - yf_d[0] ) < 1e-5;
+   ok &= fabs( c_d[n-1] - yf_d[1] ) < 1e-5;
+   //
    return ok;
 }
 // END C++
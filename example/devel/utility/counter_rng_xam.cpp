@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-23 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin counter_rng_xam.cpp dev}
+
+Counter Based Random Number Streams: Example and Test
+#####################################################
+
+{xrst_literal
+   // BEGIN C++
+   // END C++
+}
+
+{xrst_end counter_rng_xam.cpp}
+*/
+// BEGIN C++
+# include <cmath>
+# include <cppad/utility/vector.hpp>
+# include <dismod_at/counter_rng.hpp>
+
+bool counter_rng_xam(void)
+{  bool ok = true;
+   using dismod_at::data_sim_stream;
+   using dismod_at::prior_sim_stream;
+   //
+   // save the current seed so we can restore it
+   size_t save_seed = dismod_at::get_counter_seed();
+   //
+   // counter
+   dismod_at::counter_rng counter;
+   // -----------------------------------------------------------------------
+   // Known answer test: with seed zero, and all the indices zero,
+   // the first block is the Philox4x32-10 value for a zero counter and key.
+   dismod_at::set_counter_seed(0);
+   gsl_rng* rng = counter.start(data_sim_stream, 0, 0);
+   unsigned long check[] = { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 };
+   for(size_t i = 0; i < 4; ++i)
+      ok &= gsl_rng_get(rng) == check[i];
+   // -----------------------------------------------------------------------
+   // The values for a stream do not depend on what was generated before
+   dismod_at::set_counter_seed(123);
+   size_t n_value = 10;
+   CppAD::vector<double> first(n_value), second(n_value);
+   rng = counter.start(data_sim_stream, 2, 5);
+   for(size_t i = 0; i < n_value; ++i)
+      first[i] = gsl_rng_uniform(rng);
+   //
+   // use some other streams
+   rng = counter.start(prior_sim_stream, 2, 5);
+   for(size_t i = 0; i < n_value; ++i)
+      gsl_rng_uniform(rng);
+   rng = counter.start(data_sim_stream, 5, 2);
+   for(size_t i = 0; i < n_value; ++i)
+      gsl_rng_uniform(rng);
+   //
+   // same stream and indices in another counter object
+   dismod_at::counter_rng other;
+   rng = other.start(data_sim_stream, 2, 5);
+   for(size_t i = 0; i < n_value; ++i)
+      second[i] = gsl_rng_uniform(rng);
+   for(size_t i = 0; i < n_value; ++i)
+      ok &= first[i] == second[i];
+   // -----------------------------------------------------------------------
+   // A different stream, index, or seed gives different values
+   rng = counter.start(prior_sim_stream, 2, 5);
+   ok &= gsl_rng_uniform(rng) != first[0];
+   rng = counter.start(data_sim_stream, 2, 6);
+   ok &= gsl_rng_uniform(rng) != first[0];
+   dismod_at::set_counter_seed(124);
+   rng = counter.start(data_sim_stream, 2, 5);
+   ok &= gsl_rng_uniform(rng) != first[0];
+   // -----------------------------------------------------------------------
+   // Each index gives a uniform on [0, 1)
+   size_t n_sample = 100 * 100;
+   double sum      = 0.0;
+   double sum_sq   = 0.0;
+   for(size_t index = 0; index < n_sample; ++index)
+   {  rng      = counter.start(data_sim_stream, 0, index);
+      double u = gsl_rng_uniform(rng);
+      ok      &= 0.0 <= u && u < 1.0;
+      sum     += u;
+      sum_sq  += u * u;
+   }
+   double mean = sum / double(n_sample);
+   double var  = sum_sq / double(n_sample) - mean * mean;
+   ok &= std::fabs(mean - 0.5) < 4.0 * std::sqrt( 1.0 / 12.0 / n_sample );
+   ok &= std::fabs(var * 12.0 - 1.0) < 5e-2;
+   // -----------------------------------------------------------------------
+   dismod_at::set_counter_seed(save_seed);
+   return ok;
+}
+// END C++
@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-23 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin ode2_chkpoint_xam.cpp dev}
+
+C++ ode2_chkpoint: Example and Test
+###################################
+
+{xrst_literal
+   // BEGIN C++
+   // END C++
+}
+
+{xrst_end ode2_chkpoint_xam.cpp}
+*/
+// BEGIN C++
+# include <limits>
+# include <cppad/cppad.hpp>
+# include <dismod_at/eigen_ode2.hpp>
+# include <dismod_at/trap_ode2.hpp>
+# include <dismod_at/ode2_chkpoint.hpp>
+
+bool ode2_chkpoint_xam(void)
+{  bool ok = true;
+   using CppAD::vector;
+   using dismod_at::a1_double;
+   double eps = 100. * std::numeric_limits<double>::epsilon();
+   //
+   // x = (b, yi): the independent variables
+   size_t n = 6;
+   vector<double> x(n);
+   x[4] = 0.8;
+   x[5] = 0.2;
+   double tf = 2.0;
+   //
+   // must be called before recording any a1_double tape
+   dismod_at::ode2_chkpoint_setup();
+   //
+   for(size_t case_number = 0; case_number <= 4; ++case_number)
+   {  double iota  = 0.01;
+      double rho   = 0.02;
+      double chi   = 0.03;
+      double omega = 0.04;
+      if( case_number == 1 || case_number == 2 )
+         iota = 0.0;
+      if( case_number == 1 || case_number == 3 )
+         rho = 0.0;
+      x[0] = - (iota + omega);
+      x[1] = + rho;
+      x[2] = + iota;
+      x[3] = - (rho + chi + omega);
+      //
+      // f_chk: two steps recorded using ode2_chkpoint
+      // f_ode: two steps recorded using eigen_ode2 or trap_ode2
+      CppAD::ADFun<double> f_chk, f_ode;
+      for(size_t use_chk = 0; use_chk < 2; ++use_chk)
+      {  vector<a1_double> ax(n), ab(4), ay(2);
+         for(size_t j = 0; j < n; ++j)
+            ax[j] = x[j];
+         CppAD::Independent(ax);
+         for(size_t i = 0; i < 4; ++i)
+            ab[i] = ax[i];
+         ay[0] = ax[4];
+         ay[1] = ax[5];
+         a1_double atf = tf / 2.0;
+         for(size_t k = 0; k < 2; ++k)
+         {  if( use_chk == 1 )
+               ay = dismod_at::ode2_chkpoint(case_number, ab, ay, atf);
+            else if( case_number == 0 )
+               ay = dismod_at::trap_ode2(ab, ay, atf);
+            else
+               ay = dismod_at::eigen_ode2(case_number, ab, ay, atf);
+         }
+         if( use_chk == 1 )
+            f_chk.Dependent(ax, ay);
+         else
+            f_ode.Dependent(ax, ay);
+      }
+      // the checkpoint version records fewer variables
+      ok &= f_chk.size_var() < f_ode.size_var();
+      //
+      // function values
+      vector<double> y_chk = f_chk.Forward(0, x);
+      vector<double> y_ode = f_ode.Forward(0, x);
+      for(size_t i = 0; i < 2; ++i)
+         ok &= CppAD::NearEqual(y_chk[i], y_ode[i], eps, eps);
+      //
+      // first derivatives
+      vector<double> j_chk = f_chk.Jacobian(x);
+      vector<double> j_ode = f_ode.Jacobian(x);
+      for(size_t k = 0; k < 2 * n; ++k)
+         ok &= CppAD::NearEqual(j_chk[k], j_ode[k], eps, eps);
+      //
+      // second derivatives of the second component
+      vector<double> h_chk = f_chk.Hessian(x, 1);
+      vector<double> h_ode = f_ode.Hessian(x, 1);
+      for(size_t k = 0; k < n * n; ++k)
+         ok &= CppAD::NearEqual(h_chk[k], h_ode[k], eps, eps);
+   }
+   return ok;
+}
+// END C++
@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-23 Bradley M. Bell
+// ----------------------------------------------------------------------------
+/*
+{xrst_begin thread_pool_xam.cpp dev}
+
+C++ thread_pool: Example and Test
+#################################
+
+{xrst_literal
+   // BEGIN C++
+   // END C++
+}
+
+{xrst_end thread_pool_xam.cpp}
+*/
+// BEGIN C++
+# include <stdexcept>
+# include <cppad/utility/vector.hpp>
+# include <dismod_at/thread_pool.hpp>
+
+bool thread_pool_xam(void)
+{
+   bool   ok = true;
+   //
+   // create a pool with four threads
+   size_t n_thread = 4;
+   dismod_at::new_thread_pool(n_thread);
+   ok &= dismod_at::thread_pool_size() == n_thread;
+   ok &= dismod_at::thread_pool_num()  == 0;
+   ok &= ! dismod_at::thread_pool_in_parallel();
+   //
+   // one work space for each thread
+   CppAD::vector< CppAD::vector<double> > work(n_thread);
+   //
+   // result for each job
+   size_t n_job = 100;
+   CppAD::vector<double> result(n_job);
+   CppAD::vector<bool>   in_parallel(n_job), thread_ok(n_job);
+   //
+   // job: sum of the integers from zero to job_index
+   auto job = [&](size_t job_index)
+   {  size_t thread = dismod_at::thread_pool_num();
+      thread_ok[job_index]   = thread < n_thread;
+      in_parallel[job_index] = dismod_at::thread_pool_in_parallel();
+      //
+      // memory for the work space is allocated by this thread
+      CppAD::vector<double>& w = work[thread];
+      w.resize(job_index + 1);
+      for(size_t i = 0; i <= job_index; ++i)
+         w[i] = double(i);
+      double sum = 0.0;
+      for(size_t i = 0; i <= job_index; ++i)
+         sum += w[i];
+      result[job_index] = sum;
+   };
+   dismod_at::thread_pool_run(n_job, job);
+   ok &= ! dismod_at::thread_pool_in_parallel();
+   for(size_t j = 0; j < n_job; ++j)
+   {  ok &= thread_ok[j];
+      ok &= in_parallel[j];
+      ok &= result[j] == double( j * (j + 1) / 2 );
+   }
+   //
+   // exception thrown by a job is re-thrown by thread_pool_run
+   auto bad_job = [](size_t job_index)
+   {  if( job_index == 7 )
+         throw std::runtime_error("bad_job");
+   };
+   bool caught = false;
+   try
+   {  dismod_at::thread_pool_run(n_job, bad_job);
+   }
+   catch(const std::runtime_error& e)
+   {  caught = std::string( e.what() ) == "bad_job";
+   }
+   ok &= caught;
+   //
+   // in sequential mode, memory can be returned by any thread
+   for(size_t thread = 0; thread < n_thread; ++thread)
+      work[thread].clear();
+   //
+   dismod_at::free_thread_pool();
+   ok &= dismod_at::thread_pool_size() == 1;
+   //
+   return ok;
+}
+// END C++
@@ -129,6 +129,13 @@ bool time_line_vec_xam(void)
    sum_wv         += point_11.weight * point_11.value;
    double check = sum_wv / sum_w;
    ok &= std::fabs( 1.0 - avg / check ) <= eps99;
+   //
+   // check age_time_coef
+   CppAD::vector<double> coef = vec.age_time_coef();
+   ok &= coef.size() == 4;
+   check  = coef[0] * point_00.value + coef[1] * point_01.value;
+   check += coef[2] * point_10.value + coef[3] * point_11.value;
+   ok &= std::fabs( 1.0 - avg / check ) <= eps99;
    // ---------------------------------------------------------------------
    // max_time_diff
    size_t age_index;
@@ -136,6 +143,24 @@ bool time_line_vec_xam(void)
    double max_diff = vec.max_time_diff(age_index, time_index);
    check = time_upper - time_lower;
    ok   &= std::fabs( 1.0 - max_diff / check ) <= eps99;
+   // ---------------------------------------------------------------------
+   // append_point and merge
+   vec.specialize(age_lower, age_upper, time_lower, time_upper);
+   size_t n_point = 5;
+   vec.reserve(n_point);
+   for(size_t j = 0; j < n_point; ++j)
+   {  // add points in decreasing time order
+      time_point point;
+      point.time   = time_upper - double(j) * (time_upper - time_lower) / 4.0;
+      point.weight = 1.0;
+      point.value  = double(j);
+      vec.append_point(sub_lower, point);
+   }
+   vec.merge();
+   CppAD::vector<time_point> time_line = vec.time_line(sub_lower);
+   ok &= time_line.size() == n_point;
+   for(size_t j = 0; j < n_point; ++j)
+      ok &= time_line[j].value == double(n_point - j - 1);
    //
    return ok;
 }
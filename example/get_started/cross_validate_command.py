@@ -0,0 +1,126 @@
+# SPDX-License-Identifier: AGPL-3.0-or-later
+# SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+# SPDX-FileContributor: 2014-23 Bradley M. Bell
+# ----------------------------------------------------------------------------
+# {xrst_begin cross_validate_command.py}
+# {xrst_comment_ch #}
+#
+# cross_validate Command: Example and Test
+# ########################################
+#
+# Data
+# ****
+# The data table created by :ref:`get_started_db.py-name` has one row
+# that is simulated without noise.
+# This example makes a copy of that row so there are two folds
+# each with one data point.
+# The fit for one fold predicts the held out point exactly
+# and hence its weighted residual is zero.
+#
+# n_thread
+# ********
+# The command is run a second time with
+# :ref:`option_table@n_thread` equal to two,
+# so that the folds are fit in separate processes.
+# The resulting cross_validate table must be identical to the one
+# computed with one thread.
+#
+# {xrst_literal
+#     BEGIN PYTHON
+#     END PYTHON
+# }
+#
+# {xrst_end cross_validate_command.py}
+# ---------------------------------------------------------------------------
+# BEGIN PYTHON
+import sys
+import os
+import copy
+import subprocess
+# ---------------------------------------------------------------------------
+# check execution is from distribution directory
+example = 'example/get_started/cross_validate_command.py'
+if sys.argv[0] != example  or len(sys.argv) != 1 :
+   usage  = 'python3 ' + example + '\n'
+   usage += 'where python3 is the python 3 program on your system\n'
+   usage += 'and working directory is the dismod_at distribution directory\n'
+   sys.exit(usage)
+#
+# import dismod_at
+local_dir = os.getcwd() + '/python'
+if( os.path.isdir( local_dir + '/dismod_at' ) ) :
+   sys.path.insert(0, local_dir)
+import dismod_at
+#
+# import get_started_db example
+sys.path.append( os.getcwd() + '/example/get_started' )
+import get_started_db
+#
+# change into the build/example/get_started directory
+if not os.path.exists('build/example/get_started') :
+   os.makedirs('build/example/get_started')
+os.chdir('build/example/get_started')
+# ---------------------------------------------------------------------------
+# create get_started.db
+get_started_db.get_started_db()
+#
+# duplicate the data table row
+file_name  = 'get_started.db'
+connection = dismod_at.create_connection(
+   file_name, new = False, readonly = False
+)
+data_table = dismod_at.get_table_dict(connection, 'data')
+assert len(data_table) == 1
+data_table.append( copy.copy( data_table[0] ) )
+dismod_at.replace_table(connection, 'data', data_table)
+connection.close()
+# -----------------------------------------------------------------------
+program        = '../../devel/dismod_at'
+n_fold         = 2
+for command in [ 'init', 'cross_validate' ] :
+   cmd = [ program, file_name, command ]
+   if command == 'cross_validate' :
+      cmd.append( str(n_fold) )
+   print( ' '.join(cmd) )
+   flag = subprocess.call( cmd )
+   if flag != 0 :
+      sys.exit('The dismod_at ' + command + ' command failed')
+# -----------------------------------------------------------------------
+# connect to database
+connection = dismod_at.create_connection(
+   file_name, new = False, readonly = True
+)
+# -----------------------------------------------------------------------
+# check the cross_validate table
+data_table           = dismod_at.get_table_dict(connection, 'data')
+cross_validate_table = dismod_at.get_table_dict(connection, 'cross_validate')
+assert len(cross_validate_table) == 2
+for cross_validate_id in range( len(cross_validate_table) ) :
+   row            = cross_validate_table[cross_validate_id]
+   data_subset_id = row['data_subset_id']
+   assert row['fold'] == data_subset_id % n_fold
+   #
+   # data_id = data_subset_id because there is no data subsetting
+   meas_value = data_table[data_subset_id]['meas_value']
+   assert abs( row['avg_integrand'] / meas_value - 1.0 ) < 1e-6
+   assert abs( row['weighted_residual'] ) < 1e-4
+connection.close()
+# -----------------------------------------------------------------------
+# run again with the folds fit in parallel processes
+for cmd in [
+   [ program, file_name, 'set', 'option', 'n_thread', '2' ] ,
+   [ program, file_name, 'cross_validate', str(n_fold) ] ,
+] :
+   print( ' '.join(cmd) )
+   flag = subprocess.call( cmd )
+   if flag != 0 :
+      sys.exit('The dismod_at ' + cmd[2] + ' command failed')
+connection = dismod_at.create_connection(
+   file_name, new = False, readonly = True
+)
+parallel_table = dismod_at.get_table_dict(connection, 'cross_validate')
+connection.close()
+assert parallel_table == cross_validate_table
+# -----------------------------------------------------------------------
+print('cross_validate_command: OK')
+# END PYTHON
@@ -18,6 +18,16 @@
 # samples form an asymptotic approximation for the posterior distribution
 # of the :ref:`model_variables-name` .
 #
+# Fit Hessians
+# ************
+# The :ref:`option_table@save_fit_hes` option is true in this example.
+# The samples using the Hessians saved by fit both are checked against
+# the samples using Hessians that are recomputed by the sample command.
+# In addition, sample asymptotic fixed must not use the Hessians
+# saved by fit both,
+# and sample asymptotic must not use the saved Hessians after the
+# data table changes.
+#
 # Notation
 # ********
 #
@@ -287,6 +297,7 @@ def example_db (file_name) :
       { 'name':'ode_step_size',          'value':'10.0'               },
       { 'name':'random_seed',            'value':str(random_seed)     },
       { 'name':'rate_case',              'value':'iota_pos_rho_zero'  },
+      { 'name':'save_fit_hes',           'value':'true'               },
 
       { 'name':'quasi_fixed',            'value':'true'         },
       { 'name':'derivative_test_fixed',  'value':'first-order'  },
@@ -349,24 +360,39 @@ for var_id in range(len(var_table) ) :
    node_name = node_table[row['node_id']]['node_name']
    node_name2var_id[node_name] = var_id
 #
+# get_sample_array
+def get_sample_array() :
+   connection   = dismod_at.create_connection(
+      file_name, new = False, readonly = True
+   )
+   sample_table = dismod_at.get_table_dict(connection, 'sample')
+   connection.close()
+   sample_array = numpy.zeros( (number_sample, 3), dtype = float )
+   for row in sample_table :
+      var_id                              = row['var_id']
+      sample_index                        = row['sample_index']
+      sample_array[sample_index, var_id ] = row['var_value']
+   return sample_array
+#
 for variables in [ 'fixed' , 'both' ] :
    dismod_at.system_command_prc([ program, file_name, 'fit', variables ])
    dismod_at.system_command_prc(
       [ program, file_name, 'sample', 'asymptotic', variables, ns_string ]
    )
    # -----------------------------------------------------------------------
-   # sample_table
+   # fit both saved the Hessians used by sample asymptotic
    connection      = dismod_at.create_connection(
       file_name, new = False, readonly = True
    )
-   sample_table  = dismod_at.get_table_dict(connection, 'sample')
+   cursor  = connection.cursor()
+   cmd     = "select name from sqlite_master where type='table'"
+   cmd    += " and name='fit_hes'"
+   fit_hes = len( cursor.execute(cmd).fetchall() ) == 1
+   assert fit_hes == (variables == 'both')
+   connection.close()
    #
-   # var_avg, var_std
-   sample_array = numpy.zeros( (number_sample, 3), dtype = float )
-   for row in sample_table :
-      var_id                              = row['var_id']
-      sample_index                        = row['sample_index']
-      sample_array[sample_index, var_id ] = row['var_value']
+   # sample_array
+   sample_array = get_sample_array()
    #
    # compute statistics
    var_avg = numpy.average(sample_array, axis=0);
@@ -418,5 +444,60 @@ for variables in [ 'fixed' , 'both' ] :
          )
          print('random_seed = ', random_seed )
          assert(False)
+# ---------------------------------------------------------------------------
+# The fit_hes table from fit both is still in the database.
+# The same random_seed is used for each sample command, so the samples
+# using the saved Hessians should equal the samples using Hessians that
+# are recomputed by the sample command.
+saved_sample = dict()
+for variables in [ 'fixed' , 'both' ] :
+   dismod_at.system_command_prc(
+      [ program, file_name, 'sample', 'asymptotic', variables, ns_string ]
+   )
+   saved_sample[variables] = get_sample_array()
+#
+connection = dismod_at.create_connection(
+   file_name, new = False, readonly = False
+)
+dismod_at.sql_command(connection, 'DROP TABLE fit_hes')
+connection.close()
+#
+for variables in [ 'fixed' , 'both' ] :
+   dismod_at.system_command_prc(
+      [ program, file_name, 'sample', 'asymptotic', variables, ns_string ]
+   )
+   recomputed_sample = get_sample_array()
+   assert numpy.allclose(
+      saved_sample[variables], recomputed_sample, rtol = 1e-7, atol = 1e-10
+   )
+# ---------------------------------------------------------------------------
+# Changing the data after the fit changes the Hessians, so the sample
+# command must not use the fit_hes table even though fit_var has not changed.
+dismod_at.system_command_prc([ program, file_name, 'fit', 'both' ])
+connection = dismod_at.create_connection(
+   file_name, new = False, readonly = False
+)
+dismod_at.sql_command(connection, 'UPDATE data SET meas_std = 2.0 * meas_std')
+connection.close()
+dismod_at.system_command_prc(
+   [ program, file_name, 'sample', 'asymptotic', 'both', ns_string ]
+)
+changed_sample = get_sample_array()
+assert not numpy.allclose(
+   saved_sample['both'], changed_sample, rtol = 1e-7, atol = 1e-10
+)
+#
+connection = dismod_at.create_connection(
+   file_name, new = False, readonly = False
+)
+dismod_at.sql_command(connection, 'DROP TABLE fit_hes')
+connection.close()
+dismod_at.system_command_prc(
+   [ program, file_name, 'sample', 'asymptotic', 'both', ns_string ]
+)
+recomputed_sample = get_sample_array()
+assert numpy.allclose(
+   changed_sample, recomputed_sample, rtol = 1e-7, atol = 1e-10
+)
 print('sample_asy.py: OK')
 # END PYTHON
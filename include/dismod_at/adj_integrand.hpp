@@ -13,14 +13,32 @@
 # include "a1_double.hpp"
 # include "weight_info.hpp"
 # include "cov2weight_map.hpp"
+# include "grid2line.hpp"
 
 
 namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
 
 class adj_integrand {
+public:
+   // work space used by line; one for each thread that calls line
+   struct work_struct {
+      CppAD::vector<double>                      double_mulcov;
+      CppAD::vector<a1_double>                   a1_double_mulcov;
+      //
+      CppAD::vector< CppAD::vector<double> >     double_rate;
+      CppAD::vector< CppAD::vector<a1_double> >  a1_double_rate;
+      //
+      // interpolation stencil for each grid class and current line
+      CppAD::vector<grid2line_stencil>           stencil;
+      CppAD::vector<bool>                        stencil_ok;
+      //
+      work_struct(void);
+   };
 private:
    // constants
-   const std::string&                         rate_case_;
+   // cohort_ode_case_number for the rate_case option
+   const size_t                               case_number_;
+   const double                               ode_tolerance_;
    const CppAD::vector<double>&               age_table_;
    const CppAD::vector<double>&               time_table_;
    const CppAD::vector<covariate_struct>&     covariate_table_;
@@ -35,12 +53,44 @@ private:
    // Set by constructor and effectory const
    CppAD::vector<pack_info::subvec_info>      mulcov_pack_info_;
 
-   // temporaries
-   CppAD::vector<double>                      double_mulcov_;
-   CppAD::vector<a1_double>                   a1_double_mulcov_;
-   //
-   CppAD::vector< CppAD::vector<double> >     double_rate_;
-   CppAD::vector< CppAD::vector<a1_double> >  a1_double_rate_;
+   // Maps each smooth_id and weight_id to its grid class. Grids in the
+   // same class have the same age and time values and hence can use the
+   // same grid2line_stencil. Set by constructor and effectively const.
+   size_t                                     n_grid_class_;
+   CppAD::vector<size_t>                      smooth_grid_class_;
+   CppAD::vector<size_t>                      weight_grid_class_;
+
+   // stencil for a grid class and the current line
+   template <class Grid_info>
+   const grid2line_stencil& line_stencil(
+      size_t                                    grid_class       ,
+      const Grid_info&                          g_info           ,
+      const CppAD::vector<double>&              line_age         ,
+      const CppAD::vector<double>&              line_time        ,
+      work_struct&                              work
+   ) const;
+
+   // interpolate values on a smoothing grid to the current line
+   template <class Float>
+   void smooth2line(
+      size_t                                    smooth_id        ,
+      const CppAD::vector<double>&              line_age         ,
+      const CppAD::vector<double>&              line_time        ,
+      const CppAD::vector<Float>&               grid_value       ,
+      CppAD::vector<Float>&                     line_value       ,
+      work_struct&                              work
+   ) const;
+
+   // interpolate values on a weighting grid to the current line
+   template <class Float>
+   void weight2line(
+      size_t                                    weight_id        ,
+      const CppAD::vector<double>&              line_age         ,
+      const CppAD::vector<double>&              line_time        ,
+      const CppAD::vector<Float>&               grid_value       ,
+      CppAD::vector<Float>&                     line_value       ,
+      work_struct&                              work
+   ) const;
 
    // template version of line
    template <class Float>
@@ -55,14 +105,16 @@ private:
       const CppAD::vector<double>&              x                ,
       const CppAD::vector<Float>&               pack_vec         ,
       CppAD::vector<Float>&                     mulcov           ,
-      CppAD::vector< CppAD::vector<Float> >&    rate
-   );
+      CppAD::vector< CppAD::vector<Float> >&    rate             ,
+      work_struct&                              work
+   ) const;
 public:
    // adj_integrand
    adj_integrand(
       const cov2weight_map&                     cov2wight_obj    ,
       const CppAD::vector<weight_info>&         w_info_vec       ,
       const std::string&                        rate_case        ,
+      double                                    ode_tolerance    ,
       const CppAD::vector<double>&              age_table        ,
       const CppAD::vector<double>&              time_table       ,
       const CppAD::vector<covariate_struct>&    covariate_table  ,
@@ -82,8 +134,9 @@ public:
       size_t                                    child            ,
       size_t                                    subgroup_id      ,
       const CppAD::vector<double>&              x                ,
-      const CppAD::vector<double>&              pack_vec
-   );
+      const CppAD::vector<double>&              pack_vec         ,
+      work_struct&                              work
+   ) const;
    // a1_double version of line
    CppAD::vector<a1_double> line(
       size_t                                    node_id          ,
@@ -94,8 +147,9 @@ public:
       size_t                                    child            ,
       size_t                                    subgroup_id      ,
       const CppAD::vector<double>&              x                ,
-      const CppAD::vector<a1_double>&           pack_vec
-   );
+      const CppAD::vector<a1_double>&           pack_vec         ,
+      work_struct&                              work
+   ) const;
 };
 
 } // END_DISMOD_AT_NAMESPACE
@@ -19,6 +19,7 @@ Contents
 {xrst_end devel_avg_integrand}
 */
 
+# include <unordered_map>
 # include <cppad/utility/vector.hpp>
 # include "get_integrand_table.hpp"
 # include "get_subgroup_table.hpp"
@@ -33,6 +34,62 @@ Contents
 namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
 
 class avg_integrand {
+public:
+   // information, that does not depend on pack_vec, for one rectangle
+   struct plan_struct {
+      size_t                                    integrand_id;
+      bool                                      need_ode;
+      //
+      // case where the ODE is not needed: the one line in the rectangle
+      CppAD::vector<double>                     line_age;
+      CppAD::vector<double>                     line_time;
+      //
+      // case where the ODE is needed: the cohorts in the rectangle
+      CppAD::vector<double>                     extend_grid;
+      CppAD::vector<double>                     cohort_time_ini;
+      CppAD::vector<size_t>                     cohort_n_line;
+      CppAD::vector<size_t>                     cohort_first;
+      //
+      // quadrature coefficient for each point in the average
+      CppAD::vector<double>                     coefficient;
+   };
+   // a cohort in the cache used by the double version of plan_avg
+   struct cohort_struct {
+      size_t                                    node_id;
+      size_t                                    n_child;
+      size_t                                    child;
+      size_t                                    subgroup_id;
+      size_t                                    integrand_id;
+      double                                    time_ini;
+      CppAD::vector<double>                     x;
+      CppAD::vector<double>                     line_age;
+      CppAD::vector<double>                     line_adj;
+   };
+   // work space used by rectangle; one for each thread that calls rectangle
+   struct work_struct {
+      time_line_vec<double>                     time_line_object;
+      plan_struct                               plan;
+      //
+      CppAD::vector<double>                     line_age;
+      CppAD::vector<double>                     line_time;
+      CppAD::vector<double>                     line_weight;
+      CppAD::vector<double>                     weight_grid;
+      //
+      CppAD::vector<double>                     double_line_adj;
+      CppAD::vector<a1_double>                  a1_double_line_adj;
+      //
+      adj_integrand::work_struct                adjint_work;
+      //
+      // cache of cohort solutions used by the double version of plan_avg
+      // pack_version: version of pack_vec set by caller (zero for no cache)
+      // cache_version: value of pack_version when the cache was filled
+      // cohort_cache: maps a hash code for a cohort to the cohort
+      size_t                                    pack_version;
+      size_t                                    cache_version;
+      std::unordered_map<size_t, cohort_struct> cohort_cache;
+      //
+      work_struct(const CppAD::vector<double>& age_avg_grid);
+   };
 private:
    // constants
    const double                              ode_step_size_;
@@ -42,58 +99,32 @@ private:
    const CppAD::vector<integrand_struct>&    integrand_table_;
    const CppAD::vector<weight_info>&         w_info_vec_;
 
-   // temporaries used to avoid memory re-allocation (need constructor)
-   time_line_vec<double>                     double_time_line_object_;
-   time_line_vec<a1_double>                  a1_double_time_line_object_;
-   //
+   // computes adjusted integrand on a line
    adj_integrand                             adjint_obj_;
 
-   // other temporaries used to avoid memory re-allocation
-   CppAD::vector<double>                     line_age_;
-   CppAD::vector<double>                     line_time_;
-   CppAD::vector<double>                     line_weight_;
-   CppAD::vector<double>                     weight_grid_;
-   //
-   CppAD::vector<double>                     double_line_adj_;
-   CppAD::vector<a1_double>                  a1_double_line_adj_;
-
-   // template version of rectangle
+   // template version of plan_avg
    template <class Float>
-   Float rectangle(
+   Float plan_avg(
       size_t                           node_id          ,
-      double                           age_lower        ,
-      double                           age_upper        ,
-      double                           time_lower       ,
-      double                           time_upper       ,
-      size_t                           weight_id        ,
-      size_t                           integrand_id     ,
       size_t                           n_child          ,
       size_t                           child            ,
       size_t                           subgroup_id      ,
       const CppAD::vector<double>&     x                ,
       const CppAD::vector<Float>&      pack_vec         ,
-      //
-      time_line_vec<Float>&            time_line_object ,
-      CppAD::vector<Float>&            line_adj
-   );
+      const plan_struct&               plan             ,
+      CppAD::vector<Float>&            line_adj         ,
+      work_struct&                     work
+   ) const;
 
-   // add_cohort
-   template <class Float>
-   void add_cohort(
-      size_t                       node_id              ,
+   // plan_cohort
+   void plan_cohort(
       double                       time_ini             ,
       double                       time_lower           ,
       double                       time_upper           ,
-      size_t                       weight_id            ,
-      size_t                       integrand_id         ,
-      size_t                       n_child              ,
-      size_t                       child                ,
-      size_t                       subgroup_id          ,
-      const CppAD::vector<double>& x                    ,
-      const CppAD::vector<Float>&  pack_vec             ,
-      time_line_vec<Float>&        time_line_object     ,
-      CppAD::vector<Float>&        line_adj
-   );
+      const weight_info&           w_info               ,
+      plan_struct&                 plan                 ,
+      work_struct&                 work
+   ) const;
 
 public:
    // avg_integrand
@@ -101,7 +132,7 @@ public:
       const cov2weight_map&                     cov2weight_obj   ,
       double                                    ode_step_size    ,
       const std::string&                        rate_case        ,
-      const CppAD::vector<double>&              age_avg_grid     ,
+      double                                    ode_tolerance    ,
       const CppAD::vector<double>&              age_table        ,
       const CppAD::vector<double>&              time_table       ,
       const CppAD::vector<covariate_struct>&    covariate_table  ,
@@ -112,6 +143,43 @@ public:
       const CppAD::vector<smooth_info>&         s_info_vec       ,
       const pack_info&                          pack_object
    );
+   // BEGIN_MAKE_PLAN_PROTOTYPE
+   void make_plan(
+      double                           age_lower        ,
+      double                           age_upper        ,
+      double                           time_lower       ,
+      double                           time_upper       ,
+      size_t                           weight_id        ,
+      size_t                           integrand_id     ,
+      plan_struct&                     plan             ,
+      work_struct&                     work
+   ) const;
+   // END_MAKE_PLAN_PROTOTYPE
+   // BEGIN_PLAN_AVG_PROTOTYPE
+   // double version of plan_avg
+   double plan_avg(
+      size_t                           node_id          ,
+      size_t                           n_child          ,
+      size_t                           child            ,
+      size_t                           subgroup_id      ,
+      const CppAD::vector<double>&     x                ,
+      const CppAD::vector<double>&     pack_vec         ,
+      const plan_struct&               plan             ,
+      work_struct&                     work
+   ) const;
+   // a1_double version of plan_avg
+   a1_double plan_avg(
+      size_t                           node_id          ,
+      size_t                           n_child          ,
+      size_t                           child            ,
+      size_t                           subgroup_id      ,
+      const CppAD::vector<double>&     x                ,
+      const CppAD::vector<a1_double>&  pack_vec         ,
+      const plan_struct&               plan             ,
+      work_struct&                     work
+   ) const;
+   // END_PLAN_AVG_PROTOTYPE
+   // BEGIN_RECTANGLE_PROTOTYPE
    // double version of rectangle
    double rectangle(
       size_t                           node_id          ,
@@ -125,8 +193,9 @@ public:
       size_t                           child            ,
       size_t                           subgroup_id      ,
       const CppAD::vector<double>&     x                ,
-      const CppAD::vector<double>&     pack_vec
-   );
+      const CppAD::vector<double>&     pack_vec         ,
+      work_struct&                     work
+   ) const;
    // a1_double version of rectangle
    a1_double rectangle(
       size_t                           node_id          ,
@@ -140,8 +209,10 @@ public:
       size_t                           child            ,
       size_t                           subgroup_id      ,
       const CppAD::vector<double>&     x                ,
-      const CppAD::vector<a1_double>&  pack_vec
-   );
+      const CppAD::vector<a1_double>&  pack_vec         ,
+      work_struct&                     work
+   ) const;
+   // END_RECTANGLE_PROTOTYPE
 };
 
 } // END_DISMOD_AT_NAMESPACE
@@ -32,6 +32,22 @@ Contents
 namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
 
 class avg_noise_effect {
+public:
+   // work space used by rectangle; one for each thread that calls rectangle
+   struct work_struct {
+      time_line_vec<double>                     double_time_line_object;
+      time_line_vec<a1_double>                  a1_double_time_line_object;
+      //
+      CppAD::vector<double>                     line_age;
+      CppAD::vector<double>                     line_time;
+      CppAD::vector<double>                     line_weight;
+      CppAD::vector<double>                     weight_grid;
+      //
+      CppAD::vector<double>                     double_effect;
+      CppAD::vector<a1_double>                  a1_double_effect;
+      //
+      work_struct(const CppAD::vector<double>& age_avg_grid);
+   };
 private:
    // constants
    const double                              ode_step_size_;
@@ -43,19 +59,6 @@ private:
    const CppAD::vector<smooth_info>&         s_info_vec_;
    const pack_info&                          pack_object_;
 
-   // temporaries used to avoid memory re-allocation (need constructor)
-   time_line_vec<double>                     double_time_line_object_;
-   time_line_vec<a1_double>                  a1_double_time_line_object_;
-
-   // other temporaries used to avoid memory re-allocation
-   CppAD::vector<double>                     line_age_;
-   CppAD::vector<double>                     line_time_;
-   CppAD::vector<double>                     line_weight_;
-   CppAD::vector<double>                     weight_grid_;
-   //
-   CppAD::vector<double>                     double_effect_;
-   CppAD::vector<a1_double>                  a1_double_effect_;
-
    // template version of rectangle
    template <class Float>
    Float rectangle(
@@ -70,14 +73,14 @@ private:
       const CppAD::vector<Float>&      pack_vec         ,
       //
       time_line_vec<Float>&            time_line_object ,
-      CppAD::vector<Float>&            effect
-   );
+      CppAD::vector<Float>&            effect           ,
+      work_struct&                     work
+   ) const;
 
 public:
    // avg_noise_effect
    avg_noise_effect(
       double                                    ode_step_size    ,
-      const CppAD::vector<double>&              age_avg_grid     ,
       const CppAD::vector<double>&              age_table        ,
       const CppAD::vector<double>&              time_table       ,
       const CppAD::vector<subgroup_struct>&     subgroup_table   ,
@@ -96,8 +99,9 @@ public:
       size_t                           subgroup_id      ,
       size_t                           integrand_id     ,
       const CppAD::vector<double>&     x                ,
-      const CppAD::vector<double>&     pack_vec
-   );
+      const CppAD::vector<double>&     pack_vec         ,
+      work_struct&                     work
+   ) const;
    // a1_double version of rectangle
    a1_double rectangle(
       double                           age_lower        ,
@@ -108,8 +112,9 @@ public:
       size_t                           subgroup_id      ,
       size_t                           integrand_id     ,
       const CppAD::vector<double>&     x                ,
-      const CppAD::vector<a1_double>&  pack_vec
-   );
+      const CppAD::vector<a1_double>&  pack_vec         ,
+      work_struct&                     work
+   ) const;
 };
 
 } // END_DISMOD_AT_NAMESPACE
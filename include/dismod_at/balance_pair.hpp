@@ -14,7 +14,7 @@ Syntax
 ******
 
 | *sample_vec* = ``dismod_at::balance_pair`` (
-| |tab| *n_sample* , *pair_vec* , *second_1* , *second_2*
+| |tab| *n_sample* , *pair_vec* , *second_1* , *second_2* [ , *rng* ]
 | )
 
 Prototype
@@ -51,6 +51,12 @@ second_2
 ********
 Is the larger of the two opposite second values in a pair.
 
+rng
+***
+If this argument is present and not ``nullptr`` ,
+it is the random number generator used for the sampling.
+Otherwise the generator managed by :ref:`manage_gsl_rng-name` is used.
+
 sample_vec
 **********
 is the set of indices in *pair_vec* corresponding to the
@@ -77,7 +83,8 @@ CppAD::vector<size_t> balance_pair(
    size_t                                           n_sample  ,
    const CppAD::vector< std::pair<First, Second> >& pair_vec  ,
    const Second&                                    second_1 ,
-   const Second&                                    second_2 )
+   const Second&                                    second_2 ,
+   gsl_rng*                                         rng = nullptr )
 // END_PROTOTYPE
 {  //
    // pair_t
@@ -93,7 +100,8 @@ CppAD::vector<size_t> balance_pair(
    assert( n_sample <= n_pair );
    //
    // rng
-   gsl_rng* rng = CppAD::mixed::get_gsl_rng();
+   if( rng == nullptr )
+      rng = CppAD::mixed::get_gsl_rng();
    //
    // random_order
    CppAD::vector<size_t> random_order(n_pair);
@@ -14,6 +14,7 @@ class child_info {
 private:
    CppAD::vector<size_t> child_id2node_id_;
    CppAD::vector<size_t> table_id2child_;
+   CppAD::vector<size_t> node_id2child_;
 public:
    template <class Row>
    child_info(
@@ -24,6 +25,7 @@ public:
    size_t child_size(void) const;
    size_t child_id2node_id(size_t child_id) const;
    size_t table_id2child(size_t table_id) const;
+   size_t node_id2child(size_t node_id) const;
 };
 
 } // END DISMOD_AT_NAMESPACE
@@ -9,9 +9,25 @@
 
 namespace dismod_at {
 
+   extern size_t cohort_ode_case_number(const std::string& rate_case);
+
+   template <class Float>
+   extern void cohort_ode(
+      size_t                       case_number ,
+      double                       ode_tolerance ,
+      const CppAD::vector<double>& age       ,
+      const Float&                 pini      ,
+      const CppAD::vector<Float>&  iota      ,
+      const CppAD::vector<Float>&  rho       ,
+      const CppAD::vector<Float>&  chi       ,
+      const CppAD::vector<Float>&  omega     ,
+            CppAD::vector<Float>&  s_out     ,
+            CppAD::vector<Float>&  c_out
+   );
    template <class Float>
    extern void cohort_ode(
       const std::string&           rate_case ,
+      double                       ode_tolerance ,
       const CppAD::vector<double>& age       ,
       const Float&                 pini      ,
       const CppAD::vector<Float>&  iota      ,
@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-23 Bradley M. Bell
+// ----------------------------------------------------------------------------
+# ifndef DISMOD_AT_COUNTER_RNG_HPP
+# define DISMOD_AT_COUNTER_RNG_HPP
+
+# include <cstddef>
+# include <gsl/gsl_rng.h>
+
+namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
+   // BEGIN_COUNTER_RNG_PROTOTYPE
+   enum counter_stream_enum {
+      data_sim_stream,
+      prior_sim_stream,
+      hold_out_stream
+   };
+   void   set_counter_seed(size_t seed);
+   size_t get_counter_seed(void);
+   class counter_rng {
+   private:
+      gsl_rng* rng_;
+   public:
+      counter_rng(void);
+      counter_rng(const counter_rng&) = delete;
+      counter_rng& operator=(const counter_rng&) = delete;
+      ~counter_rng(void);
+      gsl_rng* start(
+         counter_stream_enum stream  ,
+         size_t              index_0 ,
+         size_t              index_1
+      );
+   };
+   // END_COUNTER_RNG_PROTOTYPE
+} // END_DISMOD_AT_NAMESPACE
+
+# endif
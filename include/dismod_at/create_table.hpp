@@ -18,6 +18,16 @@ namespace dismod_at {
       const CppAD::vector<bool>&          col_unique     ,
       const CppAD::vector<std::string>&   row_value
    );
+   void create_table(
+      sqlite3*                            db             ,
+      const std::string&                  table_name     ,
+      const CppAD::vector<std::string>&   col_name       ,
+      const CppAD::vector<std::string>&   col_type       ,
+      const CppAD::vector<bool>&          col_unique     ,
+      size_t                              n_row          ,
+      const CppAD::vector<int>&           int_value      ,
+      const CppAD::vector<double>&        real_value
+   );
 }
 
 # endif
@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-23 Bradley M. Bell
+// ----------------------------------------------------------------------------
+# ifndef DISMOD_AT_CROSS_VALIDATE_COMMAND_HPP
+# define DISMOD_AT_CROSS_VALIDATE_COMMAND_HPP
+
+# include <string>
+# include <map>
+# include <sqlite3.h>
+# include <cppad/utility/vector.hpp>
+# include <dismod_at/data_model.hpp>
+# include <dismod_at/prior_model.hpp>
+# include <dismod_at/pack_info.hpp>
+# include <dismod_at/pack_prior.hpp>
+# include <dismod_at/get_db_input.hpp>
+# include <dismod_at/subset_data.hpp>
+
+namespace dismod_at {
+   void cross_validate_command(
+      const std::string&                                   n_fold_arg        ,
+      sqlite3*                                             db                ,
+      const CppAD::vector<dismod_at::subset_data_struct>&  subset_data_obj   ,
+      dismod_at::data_model&                               data_object       ,
+      const dismod_at::prior_model&                        prior_object      ,
+      const dismod_at::pack_info&                          pack_object       ,
+      const dismod_at::pack_prior&                         var2prior         ,
+      const dismod_at::db_input_struct&                    db_input          ,
+      const std::map<std::string, std::string>&            option_map
+   );
+}
+
+# endif
@@ -6,6 +6,7 @@
 # define DISMOD_AT_DATA_MODEL_HPP
 
 # include <limits>
+# include <vector>
 # include <cppad/utility/vector.hpp>
 # include "subset_data.hpp"
 # include "get_integrand_table.hpp"
@@ -57,12 +58,23 @@ private:
    CppAD::vector<subset_data_struct>         subset_data_obj_;
 
    // Used to compute average of integrands
-   // (effectively const)
-   avg_integrand                avgint_obj_;
+   const avg_integrand                          avgint_obj_;
 
    // Used to compute average of noise effects
-   // (effectively const)
-   avg_noise_effect             avg_noise_obj_;
+   const avg_noise_effect                       avg_noise_obj_;
+
+   // work space for avgint_obj_ and avg_noise_obj_;
+   // one for each thread in the thread pool
+   std::vector<avg_integrand::work_struct>      avgint_work_;
+   std::vector<avg_noise_effect::work_struct>   avg_noise_work_;
+
+   // first subset_id that has the same average integrand as each subset_id;
+   // set by constructor and not changed
+   CppAD::vector<size_t>                        unique_subset_id_;
+
+   // plan for computing the average integrand for each unique subset_id;
+   // set by constructor and not changed
+   CppAD::vector<avg_integrand::plan_struct>    avgint_plan_;
 
 public:
    template <class SubsetStruct>
@@ -72,6 +84,7 @@ public:
       bool                                     fit_simulated_data ,
       const std::string&                       meas_noise_effect  ,
       const std::string&                       rate_case          ,
+      double                                   ode_tolerance      ,
       double                                   bound_random       ,
       double                                   ode_step_size      ,
       const CppAD::vector<double>&             age_avg_grid       ,
@@ -95,6 +108,9 @@ public:
       const CppAD::vector<subset_data_struct>& subset_data_obj
    );
    //
+   // turn the double average cohort cache on (for a new pack_vec) or off
+   void set_cohort_cache(bool on);
+   //
    // compute an average integrand: data_model is effectively const
    template <class Float>
    Float average(
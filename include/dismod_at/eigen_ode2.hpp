@@ -15,5 +15,11 @@ namespace dismod_at {
       const CppAD::vector<Float>&  yi          ,
       const Float&                 tf
    );
+   template <size_t case_number, class Float>
+   extern CppAD::vector<Float> eigen_ode2(
+      const CppAD::vector<Float>&  b           ,
+      const CppAD::vector<Float>&  yi          ,
+      const Float&                 tf
+   );
 }
 # endif
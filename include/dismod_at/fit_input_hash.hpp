@@ -0,0 +1,19 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-23 Bradley M. Bell
+// ----------------------------------------------------------------------------
+# ifndef DISMOD_AT_FIT_INPUT_HASH_HPP
+# define DISMOD_AT_FIT_INPUT_HASH_HPP
+
+# include <sqlite3.h>
+# include <map>
+# include <string>
+
+namespace dismod_at {
+   double fit_input_hash(
+      sqlite3*                                    db         ,
+      const std::map<std::string, std::string>&   option_map
+   );
+}
+
+# endif
@@ -171,6 +171,10 @@ namespace dismod_at {
       CppAD::mixed::d_sparse_rcv random_obj_hes(
          const CppAD::vector<double>&   pack_vec
       );
+      // fixed_obj_hes
+      CppAD::mixed::d_sparse_rcv fixed_obj_hes(
+         const CppAD::vector<double>&   pack_vec
+      );
       // cppad_mixed_info
       std::map<std::string, size_t> cppad_mixed_info(void) const
       {  return cppad_mixed_info_; }
@@ -5,6 +5,7 @@
 # ifndef DISMOD_AT_GET_DB_INPUT_HPP
 # define DISMOD_AT_GET_DB_INPUT_HPP
 
+# include <map>
 # include <string>
 # include <sqlite3.h>
 # include <cppad/utility/vector.hpp>
@@ -54,6 +55,8 @@ namespace dismod_at {
       CppAD::vector<std::string>        nslist_table;
       CppAD::vector<nslist_pair_struct> nslist_pair_table;
       CppAD::vector<subgroup_struct>    subgroup_table;
+      //
+      std::map<std::string, double>     table_seconds;
    };
    // END STRUCT
    extern void get_db_input(
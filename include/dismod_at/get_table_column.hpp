@@ -32,6 +32,15 @@ namespace dismod_at {
       const std::string&          column_name           ,
       CppAD::vector<double>&      double_result
    );
+   extern size_t get_table_column(
+      sqlite3*                            db             ,
+      const std::string&                  table_name     ,
+      const CppAD::vector<std::string>&   col_name       ,
+      const CppAD::vector<std::string>&   col_type       ,
+      CppAD::vector<int>&                 int_result     ,
+      CppAD::vector<double>&              real_result    ,
+      CppAD::vector<std::string>&         text_result
+   );
 }
 
 # endif
@@ -9,6 +9,35 @@
 
 namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
 
+// BEGIN_GRID2LINE_STENCIL_PROTOTYPE
+class grid2line_stencil {
+private:
+   // number of points in the line
+   size_t                n_line_;
+   // index in grid_value for each of the four corners of each line point
+   CppAD::vector<size_t> index_;
+   // bilinear coefficient for each of the four corners of each line point
+   CppAD::vector<double> coef_;
+   // grid age and time values (work space used by set)
+   CppAD::vector<double> grid_age_;
+   CppAD::vector<double> grid_time_;
+public:
+   grid2line_stencil(void);
+   template <class Grid_info> void set(
+      const CppAD::vector<double>& line_age     ,
+      const CppAD::vector<double>& line_time    ,
+      const CppAD::vector<double>& age_table    ,
+      const CppAD::vector<double>& time_table   ,
+      const Grid_info&             g_info
+   );
+   size_t size(void) const;
+   template <class Float> void eval(
+      const CppAD::vector<Float>&  grid_value   ,
+      CppAD::vector<Float>&        line_value
+   ) const;
+};
+// END_GRID2LINE_STENCIL_PROTOTYPE
+
 template <class Grid_info, class Float>
 CppAD::vector<Float> grid2line(
    const CppAD::vector<double>& line_age     ,
@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-23 Bradley M. Bell
+// ----------------------------------------------------------------------------
+# ifndef DISMOD_AT_PACK_FIT_HES_HPP
+# define DISMOD_AT_PACK_FIT_HES_HPP
+
+# include <cppad/mixed/typedef.hpp>
+# include <cppad/utility/vector.hpp>
+
+namespace dismod_at {
+   CppAD::vector<double> pack_fit_hes(
+      int                                sim_index      ,
+      double                             bound_random   ,
+      double                             input_hash     ,
+      const CppAD::vector<double>&       fit_var_value  ,
+      const CppAD::mixed::d_sparse_rcv&  hes_fixed      ,
+      const CppAD::mixed::d_sparse_rcv&  hes_random
+   );
+   void unpack_fit_hes(
+      const CppAD::vector<double>&       vec            ,
+      int&                               sim_index      ,
+      double&                            bound_random   ,
+      double&                            input_hash     ,
+      CppAD::vector<double>&             fit_var_value  ,
+      CppAD::mixed::d_sparse_rcv&        hes_fixed      ,
+      CppAD::mixed::d_sparse_rcv&        hes_random
+   );
+}
+
+# endif
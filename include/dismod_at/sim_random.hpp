@@ -5,6 +5,7 @@
 # ifndef DISMOD_AT_SIM_RANDOM_HPP
 # define DISMOD_AT_SIM_RANDOM_HPP
 
+# include <gsl/gsl_rng.h>
 # include <dismod_at/get_density_table.hpp>
 
 namespace dismod_at {
@@ -15,6 +16,14 @@ namespace dismod_at {
       double       eta,
       double       nu
    );
+   double sim_random(
+      gsl_rng*     rng,
+      density_enum density,
+      double       mu,
+      double       delta,
+      double       eta,
+      double       nu
+   );
 }
 
 # endif
@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-23 Bradley M. Bell
+// ----------------------------------------------------------------------------
+# ifndef DISMOD_AT_TABLE_WRITER_HPP
+# define DISMOD_AT_TABLE_WRITER_HPP
+
+# include <sqlite3.h>
+# include <string>
+# include <cppad/utility/vector.hpp>
+
+namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
+
+class table_writer {
+private:
+   // database connection
+   sqlite3*                     db_;
+   // name of the table
+   const std::string            table_name_;
+   // type for each column (not including the primary key)
+   const CppAD::vector<std::string> col_type_;
+   // number of rows between commits
+   const size_t                 n_commit_;
+   // prepared insert statement (null after close)
+   sqlite3_stmt*                p_stmt_;
+   // number of rows written so far
+   size_t                       n_row_;
+   // number of rows written since the last commit
+   size_t                       n_pending_;
+   //
+   // rollback the current transaction and exit with an error message
+   void fail(const std::string& message);
+public:
+   // BEGIN_TABLE_WRITER_PROTOTYPE
+   table_writer(
+      sqlite3*                            db             ,
+      const std::string&                  table_name     ,
+      const CppAD::vector<std::string>&   col_name       ,
+      const CppAD::vector<std::string>&   col_type       ,
+      const CppAD::vector<bool>&          col_unique     ,
+      size_t                              n_commit
+   );
+   ~table_writer(void);
+   void set_integer(size_t col_index, int                value);
+   void set_real(   size_t col_index, double             value);
+   void set_text(   size_t col_index, const std::string& value);
+   void set_null(   size_t col_index);
+   void next_row(void);
+   size_t n_row(void) const;
+   void close(void);
+   // END_TABLE_WRITER_PROTOTYPE
+};
+
+} // END_DISMOD_AT_NAMESPACE
+
+# endif
@@ -0,0 +1,25 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-23 Bradley M. Bell
+// ----------------------------------------------------------------------------
+# ifndef DISMOD_AT_THREAD_POOL_HPP
+# define DISMOD_AT_THREAD_POOL_HPP
+
+# include <cstddef>
+# include <functional>
+
+namespace dismod_at { // BEGIN_DISMOD_AT_NAMESPACE
+   // BEGIN_THREAD_POOL_PROTOTYPE
+   void new_thread_pool(size_t n_thread);
+   size_t thread_pool_size(void);
+   size_t thread_pool_num(void);
+   bool thread_pool_in_parallel(void);
+   void thread_pool_run(
+      size_t                              n_job ,
+      const std::function<void(size_t)>&  job
+   );
+   void free_thread_pool(void);
+   // END_THREAD_POOL_PROTOTYPE
+} // END_DISMOD_AT_NAMESPACE
+
+# endif
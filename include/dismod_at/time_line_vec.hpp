@@ -35,6 +35,10 @@ private:
    // vec_ has the same size as sub_grid_ and
    // vec_[j] contains the line for sub_grid_[j]
    CppAD::vector< CppAD::vector<time_point> >  vec_;
+   //
+   // n_sorted_[j] is the number of points at the beginning of vec_[j]
+   // that are in sorted order; the rest were added by append_point
+   CppAD::vector<size_t> n_sorted_;
 public:
    // near_equal
    static bool near_equal(double x, double y);
@@ -58,11 +62,22 @@ public:
    // sub_upper
    size_t sub_upper(void) const;
    //
+   // reserve
+   void reserve(size_t n_time);
+   //
    // add_point
    void add_point(
       const size_t&     age_index ,
       const time_point& point
    );
+   // append_point
+   void append_point(
+      const size_t&     age_index ,
+      const time_point& point
+   );
+   // merge
+   void merge(void);
+   //
    // time_line
    const CppAD::vector<time_point>& time_line(
       const size_t& age_index
@@ -73,6 +88,9 @@ public:
    //
    // age_time_avg
    Float age_time_avg(void) const;
+   //
+   // age_time_coef
+   CppAD::vector<double> age_time_coef(void) const;
 };
 
 } // END_DISMOD_AT_NAMESPACE
@@ -1225,7 +1225,9 @@ def db2csv_command(database_file_arg) :
       [ "max_num_iter_random",               "100"],
       [ "meas_noise_effect",                 "add_std_scale_all"],
       [ "method_random",                     "ipopt_random"],
+      [ "n_thread",                          "1"],
       [ "ode_step_size",                     "10.0"],
+      [ "ode_tolerance",                     ""],
       [ "other_database",                    ""],
       [ "other_input_table",                 ""],
       [ "ode_step_size",                     "10.0"],
@@ -1236,9 +1238,11 @@ def db2csv_command(database_file_arg) :
       [ "quasi_fixed",                       "true"],
       [ "random_seed",                       "0"],
       [ "rate_case",                         "iota_pos_rho_zero"],
+      [ "save_fit_hes",                      "false"],
       [ "splitting_covariate",               ""],
       [ "tolerance_fixed",                   "1e-8"],
       [ "tolerance_random",                  "1e-8"],
+      [ "trace_db_input",                    "false"],
       [ "trace_init_fit_model",              "false"],
       [ "warn_on_stderr",                    "true"],
       [ "zero_sum_child_rate",               ""],
@@ -0,0 +1,292 @@
+// SPDX-License-Identifier: AGPL-3.0-or-later
+// SPDX-FileCopyrightText: University of Washington <https://www.washington.edu>
+// SPDX-FileContributor: 2014-23 Bradley M. Bell
+// ----------------------------------------------------------------------------
+# include <limits>
+# include <dismod_at/adj_integrand.hpp>
+# include <dismod_at/null_int.hpp>
+
+// Testing adj_integrand::line when smoothings share age and time ids,
+// so they share one interpolation stencil, and when they do not.
+
+namespace {
+   // iota on smoothing grid 0
+   double iota(double age, double time)
+   {  double t = time - 1980.0;
+      return 0.01 + 1e-4 * age + 2e-4 * t + 1e-6 * age * t;
+   }
+   // covariate multiplier on smoothing grid 1 (same ids as grid 0)
+   double mulcov_1(double age, double time)
+   {  double t = time - 1980.0;
+      return 0.5 - 2e-3 * age + 1e-2 * t - 1e-4 * age * t;
+   }
+   // covariate multiplier on smoothing grid 2 (different ids)
+   double mulcov_2(double age)
+   {  return 0.2 + 1e-2 * age;
+   }
+}
+bool adj_integrand_grid(void)
+{  bool   ok = true;
+   using CppAD::vector;
+   typedef double Float;
+   double eps99 = 99.0 * std::numeric_limits<double>::epsilon();
+   //
+   // rate_case
+   std::string rate_case = "iota_pos_rho_zero";
+   //
+   // ode_tolerance
+   double ode_tolerance = 0.0;
+   //
+   // age_table
+   size_t n_age_table = 6;
+   vector<double> age_table(n_age_table);
+   for(size_t i = 0; i < n_age_table; ++i)
+      age_table[i] = 20.0 * double(i);
+   //
+   // time_table
+   size_t n_time_table = 5;
+   vector<double> time_table(n_time_table);
+   for(size_t j = 0; j < n_time_table; ++j)
+      time_table[j] = 1980.0 + 10.0 * double(j);
+   //
+   // s_info_vec
+   // smoothing 0 and 1 have the same age and time ids, smoothing 2 does not
+   size_t n_smooth = 3;
+   vector<dismod_at::smooth_info> s_info_vec(n_smooth);
+   for(size_t smooth_id = 0; smooth_id < n_smooth; ++smooth_id)
+   {  vector<size_t> age_id(2), time_id;
+      if( smooth_id < 2 )
+      {  age_id[0] = 1;
+         age_id[1] = 4;
+         time_id.resize(2);
+         time_id[0] = 0;
+         time_id[1] = n_time_table - 1;
+      }
+      else
+      {  age_id[0] = 0;
+         age_id[1] = n_age_table - 1;
+         time_id.resize(1);
+         time_id[0] = 2;
+      }
+      // priors are not used
+      size_t n_si = age_id.size() * time_id.size();
+      vector<size_t> value_prior_id(n_si);
+      vector<size_t> dage_prior_id(n_si);
+      vector<size_t> dtime_prior_id(n_si);
+      vector<double> const_value(n_si);
+      for(size_t k = 0; k < n_si; ++k)
+      {  value_prior_id[k] = 0;
+         dage_prior_id[k]  = 0;
+         dtime_prior_id[k] = 0;
+         const_value[k]    = std::numeric_limits<double>::quiet_NaN();
+      }
+      size_t mulstd_value   = 0;
+      size_t mulstd_dage    = 0;
+      size_t mulstd_dtime   = 0;
+      bool all_const_value  = false;
+      s_info_vec[smooth_id] = dismod_at::smooth_info(
+         age_table,
+         time_table,
+         age_id,
+         time_id,
+         value_prior_id,
+         dage_prior_id,
+         dtime_prior_id,
+         const_value,
+         mulstd_value,
+         mulstd_dage,
+         mulstd_dtime,
+         all_const_value
+      );
+   }
+   //
+   // integrand_table
+   size_t n_integrand = 1;
+   vector<dismod_at::integrand_struct> integrand_table(n_integrand);
+   size_t integrand_id = 0;
+   integrand_table[integrand_id].integrand = dismod_at::Sincidence_enum;
+   //
+   // number of children
+   size_t n_child = 0;
+   //
+   // index for parent
+   size_t child   = n_child;
+   //
+   // child_id2node_id
+   vector<size_t> child_id2node_id(n_child);
+   //
+   // subgroup_table
+   size_t n_subgroup = 1;
+   vector<dismod_at::subgroup_struct> subgroup_table(n_subgroup);
+   subgroup_table[0].subgroup_name = "world";
+   subgroup_table[0].group_id      = 0;
+   subgroup_table[0].group_name    = "world";
+   //
+   // smooth_table
+   vector<dismod_at::smooth_struct> smooth_table(n_smooth);
+   for(size_t smooth_id = 0; smooth_id < n_smooth; smooth_id++)
+   {  smooth_table[smooth_id].n_age
+         = int( s_info_vec[smooth_id].age_size() );
+      smooth_table[smooth_id].n_time
+         = int( s_info_vec[smooth_id].time_size() );
+      smooth_table[smooth_id].mulstd_value_prior_id = DISMOD_AT_NULL_INT;
+      smooth_table[smooth_id].mulstd_dage_prior_id  = DISMOD_AT_NULL_INT;
+      smooth_table[smooth_id].mulstd_dtime_prior_id = DISMOD_AT_NULL_INT;
+   }
+   //
+   // covariate_table
+   size_t n_covariate = 2;
+   vector<dismod_at::covariate_struct> covariate_table(n_covariate);
+   for(size_t covariate_id = 0; covariate_id < n_covariate; ++covariate_id)
+   {  covariate_table[covariate_id].covariate_name =
+         "x_" + CppAD::to_string(covariate_id);
+      covariate_table[covariate_id].reference      = 0.0;
+      covariate_table[covariate_id].max_difference =
+         std::numeric_limits<double>::infinity();
+   }
+   //
+   // mulcov_table
+   // covariate j multiplies iota using smoothing j + 1
+   vector<dismod_at::mulcov_struct> mulcov_table(n_covariate);
+   for(size_t mulcov_id = 0; mulcov_id < n_covariate; ++mulcov_id)
+   {  mulcov_table[mulcov_id].mulcov_type  = dismod_at::rate_value_enum;
+      mulcov_table[mulcov_id].rate_id      = int( dismod_at::iota_enum );
+      mulcov_table[mulcov_id].integrand_id = DISMOD_AT_NULL_INT;
+      mulcov_table[mulcov_id].covariate_id = int( mulcov_id );
+      mulcov_table[mulcov_id].group_id     = 0;
+      mulcov_table[mulcov_id].group_smooth_id    = int( mulcov_id + 1 );
+      mulcov_table[mulcov_id].subgroup_smooth_id = DISMOD_AT_NULL_INT;
+   }
+   //
+   // rate_table
+   vector<dismod_at::rate_struct>   rate_table(dismod_at::number_rate_enum);
+   for(size_t rate_id = 0; rate_id < rate_table.size(); rate_id++)
+   {  rate_table[rate_id].parent_smooth_id = DISMOD_AT_NULL_INT;
+      rate_table[rate_id].child_smooth_id  = DISMOD_AT_NULL_INT;
+      rate_table[rate_id].child_nslist_id  = DISMOD_AT_NULL_INT;
+   }
+   rate_table[dismod_at::iota_enum].parent_smooth_id = 0;
+   //
+   // nslist_pair
+   vector<dismod_at::nslist_pair_struct> nslist_pair(0);
+   //
+   // pack_object
+   dismod_at::pack_info pack_object(
+      n_integrand,
+      child_id2node_id,
+      subgroup_table,
+      smooth_table,
+      mulcov_table,
+      rate_table,
+      nslist_pair
+   );
+   //
+   // pack_vec
+   vector<Float> pack_vec( pack_object.size() );
+   for(size_t k = 0; k < pack_vec.size(); ++k)
+      pack_vec[k] = 0.0;
+   size_t iota_id = dismod_at::iota_enum;
+   for(size_t smooth_id = 0; smooth_id < n_smooth; ++smooth_id)
+   {  dismod_at::pack_info::subvec_info info;
+      if( smooth_id == 0 )
+         info = pack_object.node_rate_value_info(iota_id, n_child);
+      else
+         info = pack_object.group_rate_value_info(iota_id, smooth_id - 1);
+      ok &= info.smooth_id == smooth_id;
+      const dismod_at::smooth_info& s_info = s_info_vec[smooth_id];
+      size_t n_time = s_info.time_size();
+      for(size_t i = 0; i < s_info.age_size(); ++i)
+      {  double age = age_table[ s_info.age_id(i) ];
+         for(size_t j = 0; j < n_time; ++j)
+         {  double time  = time_table[ s_info.time_id(j) ];
+            size_t index = info.offset + i * n_time + j;
+            if( smooth_id == 0 )
+               pack_vec[index] = iota(age, time);
+            else if( smooth_id == 1 )
+               pack_vec[index] = mulcov_1(age, time);
+            else
+               pack_vec[index] = mulcov_2(age);
+         }
+      }
+   }
+   //
+   // adjint_obj
+   size_t n_node      = 1;
+   vector<dismod_at::weight_info> w_info_vec(0);
+   size_t n_weight = 0;
+   std::string splitting_covariate = "";
+   CppAD::vector<dismod_at::rate_eff_cov_struct> rate_eff_cov_table(0);
+   dismod_at::cov2weight_map cov2weight_obj(
+      n_node,
+      n_weight,
+      splitting_covariate,
+      covariate_table,
+      rate_eff_cov_table
+   );
+   dismod_at::adj_integrand adjint_obj(
+      cov2weight_obj,
+      w_info_vec,
+      rate_case,
+      ode_tolerance,
+      age_table,
+      time_table,
+      covariate_table,
+      subgroup_table,
+      integrand_table,
+      mulcov_table,
+      s_info_vec,
+      pack_object
+   );
+   //
+   // x
+   vector<double> x(n_covariate);
+   x[0] = 0.5;
+   x[1] = -0.25;
+   //
+   // Use the same work space for two different lines so that the
+   // stencils computed for the first line must be replaced for the second.
+   dismod_at::adj_integrand::work_struct work;
+   size_t subgroup_id = 0;
+   size_t node_id     = 0;
+   size_t n_line      = 5;
+   for(size_t line_case = 0; line_case < 2; ++line_case)
+   {  // line_age, line_time (inside the grid for smoothing 0)
+      vector<double> line_age(n_line), line_time(n_line);
+      for(size_t k = 0; k < n_line; ++k)
+      {  double s = double(k) / double(n_line - 1);
+         if( line_case == 0 )
+         {  line_age[k]  = 20.0 + 60.0 * s;
+            line_time[k] = 1985.0 + 30.0 * s;
+         }
+         else
+         {  line_age[k]  = 75.0 - 50.0 * s;
+            line_time[k] = 2010.0 - 25.0 * s * s;
+         }
+      }
+      vector<Float> adj_line = adjint_obj.line(
+         node_id,
+         line_age,
+         line_time,
+         integrand_id,
+         n_child,
+         child,
+         subgroup_id,
+         x,
+         pack_vec,
+         work
+      );
+      //
+      // check result
+      ok &= adj_line.size() == n_line;
+      for(size_t k = 0; k < n_line; ++k)
+      {  double a      = line_age[k];
+         double t      = line_time[k];
+         double effect = mulcov_1(a, t) * x[0] + mulcov_2(a) * x[1];
+         double check  = iota(a, t) * std::exp(effect);
+         // std::cout << "adj_line = " << adj_line[k];
+         // std::cout << ", check = " << check << "\n";
+         ok &= CppAD::NearEqual(adj_line[k], check, eps99, eps99);
+      }
+   }
+   return ok;
+}
@@ -78,11 +78,24 @@ bool grid2line(void)
       line_age, line_time, age_table, time_table, w_info, weight_value
    );
 
-   // check the result
+   // grid2line_stencil calculation
+   dismod_at::grid2line_stencil stencil;
+   stencil.set(line_age, line_time, age_table, time_table, w_info);
+   ok &= stencil.size() == n_line;
+   CppAD::vector<double> stencil_value(n_line);
+   stencil.eval(weight_value, stencil_value);
+   //
+   // re-use stencil for other values on the same grid
+   CppAD::vector<double> double_value(n_age * n_time);
+   for(size_t ell = 0; ell < n_age * n_time; ++ell)
+      double_value[ell] = 2.0 * weight_value[ell];
+   CppAD::vector<double> double_line(n_line);
+   stencil.eval(double_value, double_line);
+
+   // check the results
    for(size_t k = 0; k < n_line; k++)
    {  double age    = line_age[k];
       double time   = line_time[k];
-      double result = line_value[k];
       //
       size_t i = 0;
       while( i < n_age - 1 && age_table[i+1] < age )
@@ -97,12 +110,18 @@ bool grid2line(void)
       );
       //
       if( check == 0.0 )
-         ok &= fabs( result ) < eps99;
+      {  ok &= fabs( line_value[k] ) < eps99;
+         ok &= fabs( stencil_value[k] ) < eps99;
+         ok &= fabs( double_line[k] ) < eps99;
+      }
       else
-         ok  &= fabs( 1.0 - result / check ) < eps99;
+      {  ok  &= fabs( 1.0 - line_value[k] / check ) < eps99;
+         ok  &= fabs( 1.0 - stencil_value[k] / check ) < eps99;
+         ok  &= fabs( 1.0 - double_line[k] / (2.0 * check) ) < eps99;
+      }
       //
       // std::cout << ", check = " << check;
-      // std::cout << ", result = " << result << std::endl;
+      // std::cout << ", result = " << line_value[k] << std::endl;
    }
    return ok;
 }
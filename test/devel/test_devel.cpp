@@ -7,6 +7,7 @@
 # include <cstring>
 
 // this directory
+extern bool adj_integrand_grid(void);
 extern bool age_time_order(void);
 extern bool data_model_subset(void);
 extern bool grid2line(void);
@@ -48,6 +49,7 @@ namespace {
 int main(void)
 {
    // this directory
+   RUN(adj_integrand_grid);
    RUN(age_time_order);
    RUN(data_model_subset);
    RUN(grid2line);